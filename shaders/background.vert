@@ -0,0 +1,27 @@
+#version 450 core
+
+// Background layer: one flat quad per run of same-color background cells in a row.
+// Runs live in physical rows (row ring) and carry a color ref like the particles.
+
+layout(location = 0) in vec2 inPos;  // Quad vertex position (0..1)
+layout(location = 1) in uvec4 inRun; // First col, physical row, length, color ref
+
+out vec4 vColor;
+out vec2 vTexCoord;
+out vec2 vCell; // Screen cell coordinates (selection test in particle.frag)
+
+#include "frame.glsl"
+#include "palette.glsl"
+
+// Flat fill sits below the glyph dots so text stays legible
+const float BACKGROUND_LEVEL = 0.6;
+
+void main() {
+    vTexCoord = inPos;
+
+    int screenRow = screenRowOf(int(inRun.y));
+    vColor = vec4(resolveColor(unpackUnorm4x8(inRun.w), false) * BACKGROUND_LEVEL, 1.0);
+
+    vCell = vec2(float(inRun.x) + inPos.x * float(inRun.z), float(screenRow) + inPos.y);
+    gl_Position = projection * vec4(vCell * uCellSize, 0.0, 1.0);
+}
@@ -0,0 +1,22 @@
+#version 450 core
+
+// BLOOM 2/3: separable 9-tap Gaussian, run once horizontally and once vertically.
+// Neighbouring taps share one bilinear fetch: 5 texture reads per pass.
+
+in vec2 vUV;
+out vec4 fragColor;
+
+uniform sampler2D uSource;
+uniform vec2 uStep; // One source texel along the blur direction (uv)
+
+const float OFFSETS[3] = float[](0.0, 1.3846153846, 3.2307692308);
+const float WEIGHTS[3] = float[](0.2270270270, 0.3162162162, 0.0702702703);
+
+void main() {
+    vec3 sum = texture(uSource, vUV).rgb * WEIGHTS[0];
+    for (int i = 1; i < 3; ++i) {
+        sum += texture(uSource, vUV + uStep * OFFSETS[i]).rgb * WEIGHTS[i];
+        sum += texture(uSource, vUV - uStep * OFFSETS[i]).rgb * WEIGHTS[i];
+    }
+    fragColor = vec4(sum, 1.0);
+}
@@ -0,0 +1,17 @@
+#version 450 core
+
+// BLOOM 3/3: sharp scene + blurred glow into the widget framebuffer (blending off).
+// Glow intensity scales the bloom here instead of every particle fragment.
+
+in vec2 vUV;
+out vec4 fragColor;
+
+uniform sampler2D uScene;
+uniform sampler2D uBloom;
+uniform float uBloomIntensity;
+
+void main() {
+    vec4 scene = texture(uScene, vUV);
+    vec3 bloom = texture(uBloom, vUV).rgb;
+    fragColor = vec4(scene.rgb + bloom * uBloomIntensity, scene.a);
+}
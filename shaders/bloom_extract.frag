@@ -0,0 +1,23 @@
+#version 450 core
+
+// BLOOM 1/3: bright parts of the scene at reduced resolution (BloomPass).
+// The bilinear tap at a half-res texel center averages the 2x2 scene pixels below it.
+
+in vec2 vUV;
+out vec4 fragColor;
+
+uniform sampler2D uScene;
+uniform float uThreshold; // Luminance where the bloom starts
+uniform float uKnee;      // Soft transition width below the threshold
+
+void main() {
+    vec3 color = texture(uScene, vUV).rgb;
+    float luma = dot(color, vec3(0.299, 0.587, 0.114));
+    
+    // Soft knee: quadratic ramp into the threshold, linear above it
+    float soft = clamp(luma - uThreshold + uKnee, 0.0, 2.0 * uKnee);
+    soft = soft * soft / (4.0 * uKnee + 1e-5);
+    float weight = max(soft, luma - uThreshold) / max(luma, 1e-5);
+    
+    fragColor = vec4(color * weight, 1.0);
+}
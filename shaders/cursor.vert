@@ -0,0 +1,68 @@
+#version 450 core
+
+// Cursor layer: the block glyph's particles, placed and animated from uniforms only.
+// Blink toggles assemble / explode the block analytically; no physics, no uploads.
+
+layout(location = 0) in vec2 inPos;    // Quad vertex position (0..1)
+layout(location = 1) in vec4 inOffset; // Template particle: cell-relative x, y, 0, size
+
+out vec4 vColor;
+out vec2 vTexCoord;
+
+#include "frame.glsl"
+#include "look.glsl"
+
+uniform vec2 uCursorPos;     // Cell origin (px)
+uniform vec2 uCursorPrev;    // Origin before the last move
+uniform float uMoveTime;     // elapsedTime of the last move
+uniform float uToggleTime;   // elapsedTime of the last blink toggle
+uniform int uVisible;
+uniform vec3 uCursorColor;
+
+const float GLIDE_TIME = 0.06;    // Move: slide to the new cell
+const float ASSEMBLE_TIME = 0.15; // Blink on: particles converge
+const float EXPLODE_TIME = 0.2;   // Blink off: particles burst outward and fade
+
+float rand(vec2 co) {
+    return fract(sin(dot(co.xy, vec2(12.9898, 78.233))) * 43758.5453);
+}
+
+void main() {
+    vTexCoord = inPos;
+
+    float seed = float(gl_InstanceID);
+    float age = elapsedTime - uToggleTime;
+    float ang = rand(vec2(seed, 1.7)) * 6.2831853;
+    vec2 dir = vec2(cos(ang), sin(ang));
+    float dist = 40.0 + rand(vec2(seed, 4.3)) * 80.0;
+
+    vec2 burst = vec2(0.0);
+    float fade = 1.0;
+    if (uVisible != 0) {
+        float k = clamp(age / ASSEMBLE_TIME, 0.0, 1.0);
+        burst = dir * dist * (1.0 - k) * (1.0 - k);
+        fade = k;
+    } else {
+        float k = clamp(age / EXPLODE_TIME, 0.0, 1.0);
+        if (k >= 1.0) {
+            gl_Position = vec4(2.0, 2.0, 2.0, 1.0); // Clipped
+            vColor = vec4(0.0);
+            return;
+        }
+        burst = dir * dist * (1.0 - (1.0 - k) * (1.0 - k));
+        fade = 1.0 - k;
+    }
+
+    float glide = smoothstep(0.0, 1.0, clamp((elapsedTime - uMoveTime) / GLIDE_TIME, 0.0, 1.0));
+    vec2 origin = mix(uCursorPrev, uCursorPos, glide);
+
+    // Same shimmer as the text layer
+    float speed = max(0.5, uShimmerSpeed);
+    float brightness = 1.0 + sin(mod(elapsedTime, 100.0) * speed + seed) * 0.3;
+    vColor = vec4(uCursorColor, 1.0) * brightness * 1.3 * fade;
+
+    // Dot quad: DOT_EXTENT of the particle around its center (particle.frag)
+    float size = inOffset.w;
+    vec2 pos = origin + inOffset.xy + burst + size * (0.5 - 0.5 * DOT_EXTENT) + inPos * size * DOT_EXTENT;
+    gl_Position = projection * vec4(pos, 0.0, 1.0);
+}
@@ -0,0 +1,47 @@
+// Per-frame state shared by the render, background, cursor and physics programs.
+// One std140 block per pane (binding 1), written once per pass by
+// ParticleSystem::writeFrameUniforms (layout mirrored by FrameUniforms there).
+layout(std140, binding = 1) uniform Frame {
+    mat4 projection;          // Zoomed view projection
+    vec2 uResolution;
+    vec2 uCellSize;           // Grid cell size the targets were generated with
+    vec3 uColorTint;
+    float elapsedTime;        // Animation clock (s)
+    vec3 uShockwave;          // x, y (ring space), start time
+    float deltaTime;
+    ivec4 uSelection;         // Start col, row, end col, row (reading order), -1 = none
+    ivec4 uLink;              // Hovered link: row, first col, last col, unused
+    int uRowHead;             // Row ring: screen row 0 shows physical row uRowHead
+    int uRows;
+    float uShimmerSpeed;
+    float glowIntensity;
+    float uBrightness;
+    float uVibrance;
+    float uScanlineIntensity;
+    float uSpringK;
+    float uDrag;
+    float uPointScale;        // Framebuffer px per scene px (zoom x device pixel ratio)
+    // Shimmer / jitter for the current frame, indexed by the particle's shimmer flag
+    // (extra.x; the flicker seed is 0 for every particle, so these are per-frame values)
+    vec4 uShimmer[2];         // x = brightness, yz = jitter per px of particle size
+    vec4 uOrbit;              // xy = orbit offset (px) for flag 0, zw = for flag 1
+};
+
+// Screen row of a physical row (row ring)
+int screenRowOf(int physRow) {
+    if (uRowHead == 0 || uRows <= 0) return physRow;
+    int screenRow = physRow - uRowHead;
+    if (screenRow < 0) screenRow += uRows;
+    return screenRow;
+}
+
+// Selection overlay test in screen cells
+bool isSelected(ivec2 cell) {
+    if (uSelection.y < 0) return false;
+    int r = cell.y, c = cell.x;
+    if (r > uSelection.y && r < uSelection.w) return true;       // Full row in middle
+    if (r == uSelection.y && r == uSelection.w) return c >= uSelection.x && c <= uSelection.z;
+    if (r == uSelection.y) return c >= uSelection.x;             // First row
+    if (r == uSelection.w) return c <= uSelection.z;             // Last row
+    return false;
+}
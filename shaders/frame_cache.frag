@@ -0,0 +1,26 @@
+#version 450 core
+
+// Static frame cache present (FrameCache): the cached backgrounds and the two
+// shimmer-group particle layers, recombined with this frame's shimmer pulse.
+// Look, scanlines and theme are baked into the layers; only the pulse changes.
+
+out vec4 fragColor;
+
+#include "frame.glsl"
+
+uniform sampler2D uBackground;
+uniform sampler2D uGroup0;
+uniform sampler2D uGroup1;
+
+void main() {
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    vec4 background = texelFetch(uBackground, pixel, 0);
+    vec4 particles = texelFetch(uGroup0, pixel, 0) * uShimmer[0].x
+                   + texelFetch(uGroup1, pixel, 0) * uShimmer[1].x;
+    if (background.a + particles.a <= 0.0) discard; // Nothing cached here
+    
+    // Particles over their backgrounds (premultiplied, as the direct draw blends);
+    // alpha adds up like the widget framebuffer's (ONE, ONE) alpha blend
+    fragColor = vec4(particles.rgb + background.rgb * (1.0 - clamp(particles.a, 0.0, 1.0)),
+                     background.a + particles.a);
+}
@@ -0,0 +1,10 @@
+#version 450 core
+
+// One fullscreen triangle, no vertex buffers: splat resolve, bloom, frame cache and upscale passes
+out vec2 vUV;
+
+void main() {
+    vec2 corner = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+    vUV = corner;
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,70 @@
+// Dot falloff and theme pass shared by particle.frag (particles, backgrounds,
+// cursor) and the splat renderer (particle_splat.comp / splat_resolve.frag).
+
+// Variants (ShaderManager::variantDefines): THEME selects the theme pass at
+// compile time, SCANLINES is only defined while the intensity is non-zero
+#ifndef THEME
+#define THEME 0
+#endif
+
+// BLOOM (BloomPass): the phosphor glow comes from the post-process blur, particles
+// only draw their sharp core. It ends at a quarter of the particle size, so the
+// drawn quad shrinks to DOT_EXTENT of the particle: a quarter of the fragments.
+#ifdef BLOOM
+const float DOT_EXTENT = 0.5;
+#else
+const float DOT_EXTENT = 1.0;
+#endif
+
+// CRT dot: sharp core + soft phosphor glow, times glowIntensity (moved to the bloom
+// composite under BLOOM). dist: from the center in particle sizes (<= 0.5 * DOT_EXTENT)
+float dotIntensity(float dist) {
+    float core = smoothstep(0.25, 0.1, dist);
+#ifdef BLOOM
+    return core;
+#else
+    float glow = exp(-dist * 8.0) * 0.5;
+    return (core + glow) * glowIntensity;
+#endif
+}
+
+// Tint, vibrance, brightness, scanlines, synthwave gradient. Linear per pixel,
+// so the splat resolve applies it once to the summed dots.
+vec4 applyLook(vec4 color, vec2 fragCoord) {
+    // 1. Color Tint (Retro/Global)
+    color.rgb *= uColorTint;
+    
+    // Saturation / Vibrance
+    float gray = dot(color.rgb, vec3(0.299, 0.587, 0.114));
+    color.rgb = mix(vec3(gray), color.rgb, uVibrance);
+    
+    color.rgb *= uBrightness;
+    
+    // 2. Scanlines
+#ifdef SCANLINES
+    // High frequency sine wave (every 2-3 pixels)
+    float scanline = 0.5 + 0.5 * sin(fragCoord.y * 1.5);
+    color.rgb *= mix(1.0, scanline, uScanlineIntensity);
+#endif
+    
+    // 3. Synthwave Gradient (Theme 2)
+#if THEME == 2
+    {
+       // Purple top (t=1), Orange bottom (t=0)
+       // Add slight curvature?
+       float t = fragCoord.y / uResolution.y;
+       vec3 topColor = vec3(0.7, 0.0, 1.0); // Purple
+       vec3 botColor = vec3(1.0, 0.2, 0.0); // Orange
+       
+       // Use lighter mix for text legibility
+       vec3 grad = mix(botColor, topColor, t * 1.2 - 0.1);
+       color.rgb *= grad * 2.0; // Boost brightness standard
+    }
+#endif
+
+#ifdef BLOOM
+    // Float scene target: clamp like the unorm widget framebuffer does, so blending is unchanged
+    color = clamp(color, 0.0, 1.0);
+#endif
+    return color;
+}
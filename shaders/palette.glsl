@@ -0,0 +1,14 @@
+// Palette: xterm 256 colors + theme mapping (binding 0), updated without touching
+// the particles (ParticleSystem::setPaletteColor / setTheme)
+layout(std140, binding = 0) uniform Palette {
+    vec4 uPalette[256];
+    vec4 uTextBlack; // Index 0 on text pixels
+};
+
+// Color ref: a = 1 -> truecolor rgb, a = 0 -> palette index in r (RGBA8 in both layouts)
+vec3 resolveColor(vec4 ref, bool text) {
+    if (ref.a > 0.5) return ref.rgb;
+    int idx = int(ref.r * 255.0 + 0.5);
+    if (idx == 0 && text) return uTextBlack.rgb;
+    return uPalette[idx].rgb;
+}
@@ -3,62 +3,50 @@
 in vec4 vColor;
 in vec2 vTexCoord;
 
-out vec4 fragColor;
+layout(location = 0) out vec4 fragColor;
 
-uniform float glowIntensity;
-uniform float uBrightness;
-uniform float uVibrance; // NEW
-uniform float uScanlineIntensity;
-uniform vec3 uColorTint;
-uniform int uTheme;
-uniform vec2 uResolution;
+#ifdef FRAME_CACHE
+// Static frame cache (FrameCache): particles land in the layer of their shimmer
+// group, drawn with neutral shimmer; the present pass applies the live pulse
+flat in int vShimmerGroup;
+layout(location = 1) out vec4 groupColor0;
+layout(location = 2) out vec4 groupColor1;
+#endif
+
+#include "frame.glsl"
+#include "look.glsl"
+
+#ifdef BACKGROUND_LAYER
+// Flat background runs (background.vert): selection inverts per screen cell
+in vec2 vCell;
+#endif
 
 void main() {
+#ifdef BACKGROUND_LAYER
+    fragColor = vColor;
+    if (isSelected(ivec2(floor(vCell)))) fragColor.rgb = vec3(1.0) - fragColor.rgb;
+    fragColor.rgb *= glowIntensity;
+#else
+#ifdef POINT_SPRITES
+    vec2 coord = gl_PointCoord - vec2(0.5);
+#else
     vec2 coord = vTexCoord - vec2(0.5);
-    float dist = length(coord);
-    
-    if (dist > 0.5) discard;
+#endif
+    if (dot(coord, coord) > 0.25) discard;
+    float dist = length(coord) * DOT_EXTENT; // In particle sizes (quad = DOT_EXTENT of the particle)
     
     // === CRT DOT MATRIX ===
-    // Sharp bright center dot + subtle phosphor glow
-    
-    // Sharp core (the actual dot)
-    float core = smoothstep(0.25, 0.1, dist);
-    
-    // Soft phosphor glow around it
-    float glow = exp(-dist * 8.0) * 0.5;
-    
-    float intensity = (core + glow) * glowIntensity;
+    // Sharp bright center dot + subtle phosphor glow (look.glsl)
+    float intensity = dotIntensity(dist);
     
     fragColor = vColor * intensity;
+#endif
     
-    // === THEMES ===
-    // 1. Color Tint (Retro/Global)
-    fragColor.rgb *= uColorTint;
-    
-    // Saturation / Vibrance
-    float gray = dot(fragColor.rgb, vec3(0.299, 0.587, 0.114));
-    fragColor.rgb = mix(vec3(gray), fragColor.rgb, uVibrance);
-    
-    fragColor.rgb *= uBrightness;
-    
-    // 2. Scanlines
-    if (uScanlineIntensity > 0.001) {
-        // High frequency sine wave (every 2-3 pixels)
-        float scanline = 0.5 + 0.5 * sin(gl_FragCoord.y * 1.5);
-        fragColor.rgb *= mix(1.0, scanline, uScanlineIntensity);
-    }
+    // === THEMES === (look.glsl, shared with the splat resolve)
+    fragColor = applyLook(fragColor, gl_FragCoord.xy);
     
-    // 3. Synthwave Gradient (Theme 2)
-    if (uTheme == 2) {
-       // Purple top (t=1), Orange bottom (t=0)
-       // Add slight curvature?
-       float t = gl_FragCoord.y / uResolution.y;
-       vec3 topColor = vec3(0.7, 0.0, 1.0); // Purple
-       vec3 botColor = vec3(1.0, 0.2, 0.0); // Orange
-       
-       // Use lighter mix for text legibility
-       vec3 grad = mix(botColor, topColor, t * 1.2 - 0.1);
-       fragColor.rgb *= grad * 2.0; // Boost brightness standard
-    }
+#ifdef FRAME_CACHE
+    groupColor0 = (vShimmerGroup == 0) ? fragColor : vec4(0.0);
+    groupColor1 = (vShimmerGroup == 1) ? fragColor : vec4(0.0);
+#endif
 }
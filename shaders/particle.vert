@@ -1,58 +1,65 @@
 #version 450 core
 
+#ifndef POINT_SPRITES
 layout(location = 0) in vec2 inPos;       // Quad vertex position (0..1)
-layout(location = 1) in vec3 inInstancePos; // Per-instance position
-layout(location = 2) in float inSize;       // Per-instance size
-layout(location = 3) in vec4 inColor;       // Per-instance color
-layout(location = 4) in vec4 inExtra;       // Pulse, Flicker, Radius, Unused
+#endif
+#ifndef VISIBLE_LIST
+#ifdef COMPACT_PARTICLES
+layout(location = 1) in uint inOffset;      // half2 (dx, dy) from target (motion stream, x word)
+layout(location = 2) in uint inTarget;      // uint16 x, y in 1/8 px
+layout(location = 6) in uint inShape;       // half2 (z, size)
+#else
+layout(location = 1) in vec2 inInstancePos; // Per-instance position (motion stream, xy)
+layout(location = 2) in vec2 inShape;       // Per-instance z, size
+layout(location = 5) in vec2 inTarget;      // Per-instance target (row ring)
+#endif
+layout(location = 3) in vec4 inColor;       // Per-instance color ref (see resolveColor)
+layout(location = 4) in vec4 inExtra;       // Pulse, Flicker, Radius, Text pixel
+#endif
 
 out vec4 vColor;
 out vec2 vTexCoord;
+#ifdef FRAME_CACHE
+flat out int vShimmerGroup; // Cache layer (FrameCache applies the shimmer when presenting)
+#endif
 
-uniform mat4 projection;
-uniform float elapsedTime; // For animation
-uniform float uShimmerSpeed;
-
-// Pseudo-random noise
-float rand(vec2 co){
-    return fract(sin(dot(co.xy ,vec2(12.9898,78.233))) * 43758.5453);
-}
+#include "frame.glsl"
+#include "palette.glsl"
+#include "look.glsl"
+// Visible list: instances index the compacted live-particle list and per-particle
+// data is pulled from the SSBOs there
+#include "particle_instance.glsl"
 
 void main() {
-    vTexCoord = inPos;
-    
-    float pulse = inExtra.x;
-    float flicker = inExtra.y; // Seed from C++
-    
-    // Time wrapper to preserve precision
-    float time = mod(elapsedTime, 100.0);
-    
-    // NEW SHIMMER LOGIC
-    // Base glow pulsing
-    float speed = max(0.5, uShimmerSpeed); // Ensure non-zero
-    float wave = sin(time * speed + pulse * 10.0); // Offset by particle ID
+#ifdef VISIBLE_LIST
+#ifdef POINT_SPRITES
+    ParticleInstance p = fetchParticle(visible[gl_VertexID]); // Non-instanced GL_POINTS draw
+#else
+    ParticleInstance p = fetchParticle(visible[gl_InstanceID]);
+#endif
+#elif defined(COMPACT_PARTICLES)
+    // Color/extra arrive as normalized RGBA8; rebuild position from target + offset
+    vec2 targetXY = vec2(float(inTarget & 0xFFFFu), float(inTarget >> 16)) * 0.125;
+    vec2 zSize = unpackHalf2x16(inShape);
+    vec3 instancePos = vec3(targetXY + unpackHalf2x16(inOffset), zSize.x);
+    ParticleInstance p = shadeParticle(targetXY, instancePos, zSize.y, inColor, inExtra);
+#else
+    ParticleInstance p = shadeParticle(inTarget, vec3(inInstancePos, inShape.x), inShape.y, inColor, inExtra);
+#endif
+    vColor = p.color;
+#ifdef FRAME_CACHE
+    vShimmerGroup = p.shimmerGroup;
+#endif
     
-    // Organic Pulse: Normalize sin to 0.7 - 1.3
-    float brightness = 1.0 + wave * 0.3; 
-    
-    // Occasional Sparkle (High frequency noise)
-    if (uShimmerSpeed > 2.0) {
-        float spark = rand(vec2(time * speed * 5.0, flicker));
-        if (spark > 0.95) brightness += 0.5; // Sparkle
-    }
-    
-    float finalBrightness = brightness;
-    
-    // Boost Color
-    vColor = inColor * finalBrightness * 1.3; // 130% brightness boost
-    
-    // Tiny Jitter (Arcing Movement) - Sub-pixel only
-    // "Staying within confines" -> very small amplitude
-    vec2 jitter = vec2((rand(vec2(time * 5.0, flicker)) - 0.5), 
-                       (rand(vec2(time * 5.0, pulse)) - 0.5)) * inSize * 0.1;
-
-    vec2 pos = inPos * inSize + jitter; 
-    vec3 finalPos = inInstancePos + vec3(pos, 0.0);
+#ifdef POINT_SPRITES
+    // One vertex per particle: the point covers the quad the instanced path would draw
+    vTexCoord = vec2(0.5);
+    vec3 pos = p.pos + vec3(vec2(p.size * 0.5), 0.0);
+    gl_PointSize = p.size * uPointScale;
+#else
+    vTexCoord = inPos;
+    vec3 pos = p.pos + vec3(inPos * p.size, 0.0);
+#endif
     
-    gl_Position = projection * vec4(finalPos, 1.0);
+    gl_Position = projection * vec4(pos, 1.0);
 }
@@ -0,0 +1,78 @@
+// One particle as the renderers see it: particle.vert (quads / point sprites)
+// and particle_splat.comp. Needs frame.glsl, palette.glsl and look.glsl.
+
+#ifdef VISIBLE_LIST
+// Per-particle data pulled from the SSBOs by id (compacted live list at binding 9)
+layout(std430, binding = 9) readonly buffer VisibleBuffer {
+    uint visible[];
+};
+#ifdef COMPACT_PARTICLES
+layout(std430, binding = 0) readonly buffer MotionBuffer { uvec2 motions[]; };
+layout(std430, binding = 1) readonly buffer ShapeBuffer { uint shapes[]; };
+layout(std430, binding = 2) readonly buffer TargetBuffer { uint targets[]; };
+layout(std430, binding = 3) readonly buffer ExtraBuffer { uint extras[]; };
+layout(std430, binding = 4) readonly buffer ColorBuffer { uint colors[]; };
+#else
+layout(std430, binding = 0) readonly buffer MotionBuffer { vec4 motions[]; };
+layout(std430, binding = 1) readonly buffer ShapeBuffer { vec2 shapes[]; };
+layout(std430, binding = 2) readonly buffer TargetBuffer { vec2 targets[]; };
+layout(std430, binding = 3) readonly buffer ExtraBuffer { vec4 extras[]; };
+layout(std430, binding = 4) readonly buffer ColorBuffer { vec4 colors[]; };
+#endif
+#endif
+
+struct ParticleInstance {
+    vec3 pos;   // Dot quad top-left (scene px): jitter, orbit and row ring applied
+    float size; // Dot quad edge (scene px): DOT_EXTENT of the particle size
+    vec4 color; // Shimmer-boosted color, selection / link applied
+    int shimmerGroup; // Shimmer flag (extra.x): index into uShimmer / uOrbit
+};
+
+// targetXY: physical-row target; instancePos: current position + z; color / extra: RGBA refs
+ParticleInstance shadeParticle(vec2 targetXY, vec3 instancePos, float size, vec4 inColor, vec4 inExtra) {
+    // Cell of this particle (from the target, in physical rows) and its screen row
+    ivec2 cell = ivec2(floor(targetXY / uCellSize));
+    cell.y = clamp(cell.y, 0, max(uRows - 1, 0));
+    int screenRow = screenRowOf(cell.y);
+    ivec2 screenCell = ivec2(cell.x, screenRow);
+    
+    // Shimmer, sparkle, jitter and orbit are per-frame values (Frame UBO), picked by the shimmer flag
+    int flag = inExtra.x > 0.5 ? 1 : 0;
+    vec4 shimmer = uShimmer[flag];
+    vec2 orbit = (flag == 1) ? uOrbit.zw : uOrbit.xy;
+    
+    // Selection inverts, links recolor text pixels
+    vec4 baseColor = vec4(resolveColor(inColor, inExtra.w > 0.5), 1.0);
+    if (isSelected(screenCell)) baseColor.rgb = 1.0 - baseColor.rgb;
+    if (inExtra.w > 0.5 && screenRow == uLink.x && cell.x >= uLink.y && cell.x <= uLink.z) {
+        baseColor.rgb = vec3(0.0, 1.0, 1.0);
+    }
+    
+    ParticleInstance p;
+    // Boost Color
+    p.color = baseColor * shimmer.x * 1.3; // 130% brightness boost
+    
+    // Tiny Jitter (Arcing Movement) - Sub-pixel only, plus the shimmer orbit
+    p.pos = instancePos + vec3(shimmer.yz * size + orbit, 0.0);
+    p.pos.y += float(screenRow - cell.y) * uCellSize.y;
+    p.pos.xy += size * (0.5 - 0.5 * DOT_EXTENT); // Same center, smaller quad
+    p.size = size * DOT_EXTENT;
+    p.shimmerGroup = flag;
+    return p;
+}
+
+#ifdef VISIBLE_LIST
+ParticleInstance fetchParticle(uint id) {
+#ifdef COMPACT_PARTICLES
+    // Color/extra are RGBA8; rebuild position from target + offset
+    uint target = targets[id];
+    vec2 targetXY = vec2(float(target & 0xFFFFu), float(target >> 16)) * 0.125;
+    vec2 zSize = unpackHalf2x16(shapes[id]);
+    vec3 instancePos = vec3(targetXY + unpackHalf2x16(motions[id].x), zSize.x);
+    return shadeParticle(targetXY, instancePos, zSize.y, unpackUnorm4x8(colors[id]), unpackUnorm4x8(extras[id]));
+#else
+    vec2 zSize = shapes[id];
+    return shadeParticle(targets[id], vec3(motions[id].xy, zSize.x), zSize.y, colors[id], extras[id]);
+#endif
+}
+#endif
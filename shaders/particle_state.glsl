@@ -0,0 +1,22 @@
+// Per-particle state byte, four per word (binding 16, ParticleBuffers::STATE).
+// The physics pass reads it before anything else: dead and settled particles
+// exit without touching the motion / target streams.
+layout(std430, binding = 16) buffer StateBuffer {
+    uint states[];
+};
+
+// Mirrors ParticleBuffers::ParticleState
+const uint STATE_DEAD    = 0u; // Hidden / unused slot of a cell block
+const uint STATE_MOVING  = 1u; // Integrated every physics pass
+const uint STATE_SETTLED = 2u; // At its target, skipped until rewritten
+
+uint loadState(uint id) {
+    return (states[id >> 2] >> ((id & 3u) * 8u)) & 0xFFu;
+}
+
+// Neighbouring particles share the word: read-modify-write through atomics
+void storeState(uint id, uint state) {
+    uint shift = (id & 3u) * 8u;
+    atomicAnd(states[id >> 2], ~(0xFFu << shift));
+    if (state != 0u) atomicOr(states[id >> 2], state << shift);
+}
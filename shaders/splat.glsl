@@ -0,0 +1,16 @@
+// Splat accumulation buffer (binding 17, SplatLayer): two words per framebuffer
+// pixel, row-major from the bottom-left like gl_FragCoord. Each word holds two
+// 8.8 fixed-point channels, (r | g << 16) and (b | a << 16), so one atomicAdd
+// updates two channels. A channel holds up to 256: dots are clamped to
+// SPLAT_MAX_ADD, leaving room for 16 full-intensity dots on one pixel before a
+// carry reaches the neighbouring channel (text dots overlap a handful of times).
+layout(std430, binding = 17) coherent buffer SplatBuffer {
+    uint splat[];
+};
+
+const float SPLAT_ONE = 256.0;    // Fixed-point scale
+const float SPLAT_MAX_ADD = 16.0; // Per dot and channel
+
+uint splatIndex(ivec2 pixel, int width) {
+    return uint(pixel.y * width + pixel.x) * 2u;
+}
@@ -0,0 +1,23 @@
+#version 450 core
+
+// Splat resolve: converts the accumulated dots of this pixel (particle_splat.comp),
+// applies the look and clears the pixel for the next frame in the same pass
+
+out vec4 fragColor;
+
+#include "frame.glsl"
+#include "look.glsl"
+#include "splat.glsl"
+
+uniform ivec2 uFramebufferSize;
+
+void main() {
+    uint i = splatIndex(ivec2(gl_FragCoord.xy), uFramebufferSize.x);
+    uvec2 words = uvec2(splat[i], splat[i + 1u]);
+    if (words == uvec2(0u)) discard; // No dot here: background untouched
+    splat[i] = 0u;
+    splat[i + 1u] = 0u;
+    
+    vec4 color = vec4(uvec4(words.x & 0xFFFFu, words.x >> 16, words.y & 0xFFFFu, words.y >> 16)) / SPLAT_ONE;
+    fragColor = applyLook(color, gl_FragCoord.xy);
+}
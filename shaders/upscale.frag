@@ -0,0 +1,26 @@
+#version 450 core
+
+// Dynamic resolution (RenderScale): the reduced scene stretched over the widget
+// framebuffer (blending off). Bilinear taps plus an unsharp mask against the
+// four neighbours restore the dot edges the lower resolution softened; the result
+// is clamped to the neighbourhood so dots do not grow dark halos.
+
+in vec2 vUV;
+out vec4 fragColor;
+
+uniform sampler2D uScene;
+uniform vec2 uTexel;      // 1 / scene size
+uniform float uSharpness; // 0 = plain bilinear
+
+void main() {
+    vec4 center = texture(uScene, vUV);
+    vec4 north = texture(uScene, vUV + vec2(0.0, uTexel.y));
+    vec4 south = texture(uScene, vUV - vec2(0.0, uTexel.y));
+    vec4 east = texture(uScene, vUV + vec2(uTexel.x, 0.0));
+    vec4 west = texture(uScene, vUV - vec2(uTexel.x, 0.0));
+    
+    vec4 lo = min(center, min(min(north, south), min(east, west)));
+    vec4 hi = max(center, max(max(north, south), max(east, west)));
+    vec4 sharpened = center + (4.0 * center - (north + south + east + west)) * (0.25 * uSharpness);
+    fragColor = clamp(sharpened, lo, hi);
+}
@@ -4,6 +4,8 @@
 
 int main(int argc, char *argv[])
 {
+    // One share group for every pane: programs, fonts and glyph buffers live in GpuResourcePool
+    QApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
     QApplication app(argc, argv);
 
     // Set default OpenGL format
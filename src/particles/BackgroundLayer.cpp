@@ -0,0 +1,102 @@
+#include "BackgroundLayer.h"
+#include "../renderer/GpuResourcePool.h"
+#include <QDebug>
+
+BackgroundLayer::BackgroundLayer()
+{
+}
+
+BackgroundLayer::~BackgroundLayer()
+{
+    if (!m_vao) return;
+    glDeleteVertexArrays(1, &m_vao);
+    glDeleteBuffers(1, &m_quadVbo);
+    glDeleteBuffers(1, &m_runVbo);
+}
+
+void BackgroundLayer::init(GpuResourcePool* pool)
+{
+    initializeOpenGLFunctions();
+    m_pool = pool; // Program: selectVariant()
+
+    const float quadVertices[] = {
+        0.0f, 0.0f,
+        1.0f, 0.0f,
+        1.0f, 1.0f,
+        0.0f, 1.0f
+    };
+    glCreateBuffers(1, &m_quadVbo);
+    glNamedBufferData(m_quadVbo, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+    glCreateBuffers(1, &m_runVbo);
+
+    glCreateVertexArrays(1, &m_vao);
+    glBindVertexArray(m_vao);
+
+    // Attribute 0: Quad corner (vec2)
+    glBindBuffer(GL_ARRAY_BUFFER, m_quadVbo);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    // Attribute 1: Run (uvec4), one per instance
+    glBindBuffer(GL_ARRAY_BUFFER, m_runVbo);
+    glEnableVertexAttribArray(1);
+    glVertexAttribIPointer(1, 4, GL_UNSIGNED_INT, 0, nullptr);
+    glVertexAttribDivisor(1, 1);
+
+    glBindVertexArray(0);
+}
+
+void BackgroundLayer::selectVariant(const QStringList& defines)
+{
+    m_program = m_pool->program("Background", "shaders/background.vert", "shaders/particle.frag",
+                                QStringList(defines) << "BACKGROUND_LAYER");
+}
+
+void BackgroundLayer::resize(int cols, int rows)
+{
+    m_cols = cols;
+    m_rows = rows;
+    m_cells.assign((size_t)cols * rows, NO_BACKGROUND);
+    m_dirty = true;
+}
+
+void BackgroundLayer::setCell(int gridIdx, uint32_t ref)
+{
+    if (m_cells[gridIdx] == ref) return;
+    m_cells[gridIdx] = ref;
+    m_dirty = true;
+}
+
+void BackgroundLayer::rebuildRuns()
+{
+    // RUN-LENGTH MERGE: one quad per span of equal color refs (O(cells), only after a change)
+    m_runs.clear();
+    for (int r = 0; r < m_rows; ++r) {
+        const uint32_t* row = &m_cells[(size_t)r * m_cols];
+        int c = 0;
+        while (c < m_cols) {
+            uint32_t ref = row[c];
+            int first = c;
+            while (c < m_cols && row[c] == ref) ++c;
+            if (ref == NO_BACKGROUND) continue;
+            m_runs.push_back((uint32_t)first);
+            m_runs.push_back((uint32_t)r);
+            m_runs.push_back((uint32_t)(c - first));
+            m_runs.push_back(ref);
+        }
+    }
+    glNamedBufferData(m_runVbo, m_runs.size() * sizeof(uint32_t), m_runs.data(), GL_DYNAMIC_DRAW);
+    m_dirty = false;
+}
+
+void BackgroundLayer::render()
+{
+    if (!m_program) return;
+    if (m_dirty) rebuildRuns();
+    if (m_runs.empty()) return;
+
+    m_program->bind();
+    glBindVertexArray(m_vao);
+    glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, runCount());
+    glBindVertexArray(0);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QOpenGLFunctions_4_5_Core>
+#include <QOpenGLShaderProgram>
+#include <QStringList>
+#include <vector>
+#include <cstdint>
+
+class GpuResourcePool;
+
+// Cell backgrounds as flat quads (shaders/background.vert) instead of particles.
+// Contiguous cells of a row with the same background color are merged into one
+// instanced quad; runs are rebuilt only when a cell's background changed.
+class BackgroundLayer : protected QOpenGLFunctions_4_5_Core
+{
+public:
+    // Palette index 0 is the default background, which is never drawn
+    static const uint32_t NO_BACKGROUND = 0;
+
+    BackgroundLayer();
+    ~BackgroundLayer(); // GL context must be current
+
+    void init(GpuResourcePool* pool);
+    // Program variant (ShaderManager::variantDefines); compiled on first use
+    void selectVariant(const QStringList& defines);
+
+    // Cells are addressed in physical rows (row ring, see ParticleSystem)
+    void resize(int cols, int rows); // Clears every cell
+    // ref = particle color ref (palette index or truecolor, see particle.vert)
+    void setCell(int gridIdx, uint32_t ref);
+
+    // Frame / palette uniform blocks are bound by the caller
+    void render();
+
+    int runCount() const { return (int)(m_runs.size() / 4); }
+
+private:
+    void rebuildRuns();
+
+    GpuResourcePool* m_pool = nullptr;
+    QOpenGLShaderProgram* m_program = nullptr; // Owned by the pool
+    GLuint m_vao = 0;
+    GLuint m_quadVbo = 0;
+    GLuint m_runVbo = 0;
+
+    int m_cols = 0;
+    int m_rows = 0;
+    std::vector<uint32_t> m_cells; // Color ref per physical cell
+    std::vector<uint32_t> m_runs;  // uvec4 per run: first col, physical row, length, color ref
+    bool m_dirty = false;
+};
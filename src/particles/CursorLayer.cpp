@@ -0,0 +1,118 @@
+#include "CursorLayer.h"
+#include "GlyphCache.h"
+#include "../renderer/GpuResourcePool.h"
+#include <QDebug>
+
+// Match cursor.vert: nothing left to draw after EXPLODE_TIME, still after the others
+static const float GLIDE_TIME = 0.06f;
+static const float ASSEMBLE_TIME = 0.15f;
+static const float EXPLODE_TIME = 0.2f;
+
+CursorLayer::CursorLayer()
+{
+}
+
+CursorLayer::~CursorLayer()
+{
+    if (!m_vao) return;
+    glDeleteVertexArrays(1, &m_vao);
+    glDeleteBuffers(1, &m_quadVbo);
+    glDeleteBuffers(1, &m_offsetVbo);
+}
+
+void CursorLayer::init(GpuResourcePool* pool)
+{
+    initializeOpenGLFunctions();
+    m_pool = pool; // Program: selectVariant()
+
+    const float quadVertices[] = {
+        0.0f, 0.0f,
+        1.0f, 0.0f,
+        1.0f, 1.0f,
+        0.0f, 1.0f
+    };
+    glCreateBuffers(1, &m_quadVbo);
+    glNamedBufferData(m_quadVbo, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+    glCreateBuffers(1, &m_offsetVbo);
+
+    glCreateVertexArrays(1, &m_vao);
+    glBindVertexArray(m_vao);
+
+    // Attribute 0: Quad corner (vec2)
+    glBindBuffer(GL_ARRAY_BUFFER, m_quadVbo);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    glBindVertexArray(0);
+}
+
+void CursorLayer::selectVariant(const QStringList& defines)
+{
+    m_program = m_pool->program("Cursor", "shaders/cursor.vert", "shaders/particle.frag", defines);
+}
+
+void CursorLayer::setGlyph(const GlyphTemplate& glyph, uint32_t generation)
+{
+    if (glyph.slot == m_glyphSlot && generation == m_glyphGeneration) return;
+    m_glyphSlot = glyph.slot;
+    m_glyphGeneration = generation;
+
+    // Text pixels only: the block has no background part
+    m_count = glyph.fgCount;
+    GLsizeiptr bytes = (GLsizeiptr)m_count * 4 * sizeof(float);
+    if (m_count > m_capacity) {
+        // Buffer storage changed: re-point the instance attribute
+        glNamedBufferData(m_offsetVbo, bytes, glyph.offsets.data(), GL_STATIC_DRAW);
+        m_capacity = m_count;
+
+        glBindVertexArray(m_vao);
+        glBindBuffer(GL_ARRAY_BUFFER, m_offsetVbo);
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
+        glVertexAttribDivisor(1, 1);
+        glBindVertexArray(0);
+    } else if (bytes > 0) {
+        glNamedBufferSubData(m_offsetVbo, 0, bytes, glyph.offsets.data());
+    }
+}
+
+void CursorLayer::setCursor(const QVector2D& origin, bool visible, float time)
+{
+    if (!m_placed) {
+        m_pos = m_prev = origin;
+        m_placed = true;
+    } else if (origin != m_pos) {
+        m_prev = m_pos;
+        m_pos = origin;
+        m_moveTime = time;
+    }
+
+    if (visible != m_visible) {
+        m_visible = visible;
+        m_toggleTime = time;
+    }
+}
+
+bool CursorLayer::isAnimating(float time) const
+{
+    if (time - m_moveTime < GLIDE_TIME) return true;
+    return time - m_toggleTime < (m_visible ? ASSEMBLE_TIME : EXPLODE_TIME);
+}
+
+void CursorLayer::render(float time)
+{
+    if (!m_program || m_count == 0) return;
+    if (!m_visible && time - m_toggleTime >= EXPLODE_TIME) return; // Fully exploded
+
+    m_program->bind();
+    m_program->setUniformValue("uCursorPos", m_pos);
+    m_program->setUniformValue("uCursorPrev", m_prev);
+    m_program->setUniformValue("uMoveTime", m_moveTime);
+    m_program->setUniformValue("uToggleTime", m_toggleTime);
+    m_program->setUniformValue("uVisible", m_visible ? 1 : 0);
+    m_program->setUniformValue("uCursorColor", m_color);
+
+    glBindVertexArray(m_vao);
+    glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, m_count);
+    glBindVertexArray(0);
+}
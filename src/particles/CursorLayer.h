@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QOpenGLFunctions_4_5_Core>
+#include <QOpenGLShaderProgram>
+#include <QVector2D>
+#include <QStringList>
+#include <QVector3D>
+#include <cstdint>
+
+class GpuResourcePool;
+struct GlyphTemplate;
+
+// The terminal cursor as its own small particle layer (shaders/cursor.vert).
+// The block glyph's particles are uploaded once per template; moves and blink
+// toggles only change uniforms, the animation runs in the vertex shader.
+class CursorLayer : protected QOpenGLFunctions_4_5_Core
+{
+public:
+    CursorLayer();
+    ~CursorLayer(); // GL context must be current
+
+    void init(GpuResourcePool* pool);
+    // Program variant (ShaderManager::variantDefines); compiled on first use
+    void selectVariant(const QStringList& defines);
+
+    // Block glyph at the current font / density / cell size (uploads on change only)
+    void setGlyph(const GlyphTemplate& glyph, uint32_t generation);
+    void setColor(const QVector3D& color) { m_color = color; }
+
+    // origin = cell top-left in px; time = ParticleSystem animation clock
+    void setCursor(const QVector2D& origin, bool visible, float time);
+    // A glide, assemble or explode is still in progress: the owner keeps painting
+    // frames (no physics) until it ends, a settled cursor needs none
+    bool isAnimating(float time) const;
+
+    // Frame / palette uniform blocks are bound by the caller
+    QOpenGLShaderProgram* program() const { return m_program; }
+    void render(float time);
+
+private:
+    GpuResourcePool* m_pool = nullptr;
+    QOpenGLShaderProgram* m_program = nullptr; // Owned by the pool
+    GLuint m_vao = 0;
+    GLuint m_quadVbo = 0;
+    GLuint m_offsetVbo = 0;
+    int m_count = 0;
+    int m_capacity = 0;
+
+    int m_glyphSlot = -1;
+    uint32_t m_glyphGeneration = 0;
+
+    QVector2D m_pos;
+    QVector2D m_prev;
+    float m_moveTime = -1000.0f;
+    float m_toggleTime = -1000.0f;
+    bool m_visible = false;
+    bool m_placed = false;
+    QVector3D m_color = QVector3D(1.0f, 0.7f, 0.0f); // Amber
+};
@@ -0,0 +1,107 @@
+#include "FrameCache.h"
+#include "../renderer/GpuResourcePool.h"
+#include <QDebug>
+
+FrameCache::FrameCache()
+{
+}
+
+FrameCache::~FrameCache()
+{
+    if (!m_vao) return;
+    releaseTargets();
+    glDeleteVertexArrays(1, &m_vao);
+}
+
+void FrameCache::init(GpuResourcePool* pool)
+{
+    initializeOpenGLFunctions();
+    m_presentProgram = pool->program("FrameCache", "shaders/fullscreen.vert", "shaders/frame_cache.frag");
+    glCreateVertexArrays(1, &m_vao);
+}
+
+void FrameCache::releaseTargets()
+{
+    glDeleteFramebuffers(1, &m_fbo);
+    glDeleteTextures(LAYER_COUNT, m_layers);
+    m_fbo = 0;
+    for (GLuint& layer : m_layers) layer = 0;
+    m_width = m_height = 0;
+}
+
+bool FrameCache::resize(int width, int height)
+{
+    if (width == m_width && height == m_height && m_fbo) return true;
+    releaseTargets();
+    if (width <= 0 || height <= 0) return false;
+
+    // Float layers: summed particle alpha and pre-clamp colors survive until present
+    glCreateTextures(GL_TEXTURE_2D, LAYER_COUNT, m_layers);
+    glCreateFramebuffers(1, &m_fbo);
+    for (int i = 0; i < LAYER_COUNT; ++i) {
+        glTextureStorage2D(m_layers[i], 1, GL_RGBA16F, width, height);
+        glNamedFramebufferTexture(m_fbo, GL_COLOR_ATTACHMENT0 + i, m_layers[i], 0);
+    }
+    if (glCheckNamedFramebufferStatus(m_fbo, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        qWarning() << "FRAME CACHE: Incomplete framebuffer at" << width << "x" << height;
+        releaseTargets();
+        return false;
+    }
+    m_width = width;
+    m_height = height;
+    qDebug() << "FRAME CACHE: Layers" << width << "x" << height;
+    return false;
+}
+
+void FrameCache::begin(const QRect& region)
+{
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_previousFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    if (!region.isEmpty()) {
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(region.x(), region.y(), region.width(), region.height());
+    }
+
+    // Clears address draw buffers, not attachments: map every layer first.
+    // They honour the scissor: only the redrawn region is reset.
+    const GLenum buffers[LAYER_COUNT] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2 };
+    glNamedFramebufferDrawBuffers(m_fbo, LAYER_COUNT, buffers);
+    const GLfloat transparent[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < LAYER_COUNT; ++i) {
+        glClearNamedFramebufferfv(m_fbo, GL_COLOR, i, transparent);
+    }
+}
+
+void FrameCache::selectBackgroundLayer()
+{
+    const GLenum buffers[LAYER_COUNT] = { GL_COLOR_ATTACHMENT0, GL_NONE, GL_NONE };
+    glNamedFramebufferDrawBuffers(m_fbo, LAYER_COUNT, buffers);
+}
+
+void FrameCache::selectParticleLayers()
+{
+    // particle.frag (FRAME_CACHE) writes its shimmer group to outputs 1 / 2
+    const GLenum buffers[LAYER_COUNT] = { GL_NONE, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2 };
+    glNamedFramebufferDrawBuffers(m_fbo, LAYER_COUNT, buffers);
+}
+
+void FrameCache::end()
+{
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)m_previousFbo);
+}
+
+void FrameCache::present()
+{
+    m_presentProgram->bind();
+    m_presentProgram->setUniformValue("uBackground", 0);
+    m_presentProgram->setUniformValue("uGroup0", 1);
+    m_presentProgram->setUniformValue("uGroup1", 2);
+    for (int i = 0; i < LAYER_COUNT; ++i) glBindTextureUnit(i, m_layers[i]);
+
+    glBindVertexArray(m_vao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+
+    for (int i = 0; i < LAYER_COUNT; ++i) glBindTextureUnit(i, 0);
+}
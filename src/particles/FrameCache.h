@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QOpenGLFunctions_4_5_Core>
+#include <QOpenGLShaderProgram>
+#include <QRect>
+
+class GpuResourcePool;
+
+// Static frame cache (shaders/frame_cache.frag). Once the particles settle, the
+// particle pass is drawn once into offscreen layers and re-presented by one
+// full-screen pass per frame. Backgrounds and the two shimmer groups get their
+// own layers (drawn with neutral shimmer), so the pulse stays live when presenting.
+// Changed cells are redrawn into the layers through a scissor rectangle.
+class FrameCache : protected QOpenGLFunctions_4_5_Core
+{
+public:
+    FrameCache();
+    ~FrameCache(); // GL context must be current
+
+    void init(GpuResourcePool* pool);
+    bool isAvailable() const { return m_presentProgram != nullptr; }
+
+    // Framebuffer px; false when the layers were (re)created and hold nothing yet
+    bool resize(int width, int height);
+
+    // Redraw: binds the layers and clears region (framebuffer px, bottom-left origin;
+    // empty = everything). Draw calls between begin() and end() are scissored to it.
+    void begin(const QRect& region);
+    void selectBackgroundLayer(); // Draw buffers: background layer only
+    void selectParticleLayers();  // Draw buffers: both shimmer groups (FRAME_CACHE variant)
+    void end();                   // Back to the framebuffer bound before begin()
+
+    // Frame block bound by the caller (uShimmer); blends like the direct draw
+    void present();
+
+private:
+    void releaseTargets();
+
+    enum Layer { BACKGROUND = 0, SHIMMER_GROUP0, SHIMMER_GROUP1, LAYER_COUNT };
+
+    QOpenGLShaderProgram* m_presentProgram = nullptr; // Owned by the pool
+    GLuint m_vao = 0; // Attribute-less fullscreen triangle
+    GLuint m_fbo = 0;
+    GLuint m_layers[LAYER_COUNT] = {};
+    int m_width = 0;
+    int m_height = 0;
+    GLint m_previousFbo = 0;
+};
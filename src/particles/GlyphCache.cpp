@@ -0,0 +1,147 @@
+#include "GlyphCache.h"
+#include <QRandomGenerator>
+#include <algorithm>
+#include <cmath>
+
+GlyphCache::GlyphCache()
+{
+    m_jitterTable.resize(JITTER_SIZE);
+    auto* gen = QRandomGenerator::global();
+    for (size_t i = 0; i < m_jitterTable.size(); ++i) {
+        m_jitterTable[i] = (gen->generateDouble() - 0.5) * 2.0; // -1 to 1
+    }
+}
+
+void GlyphCache::setFont(const FontAsset* font, int fontId)
+{
+    // Keys include the font id: switching keeps the other fonts' templates
+    m_font = font;
+    m_fontId = fontId;
+}
+
+void GlyphCache::clear()
+{
+    m_templates.clear();
+    m_pending.clear();
+    m_slotCount = 0;
+    m_gpuParticleCount = 0;
+    m_jitterIndex = 0;
+}
+
+std::vector<const GlyphTemplate*> GlyphCache::takePending()
+{
+    std::vector<const GlyphTemplate*> out;
+    out.swap(m_pending);
+    return out;
+}
+
+const GlyphTemplate& GlyphCache::get(uint32_t glyph, int density, float cellWidth, float cellHeight)
+{
+    Key key{ m_fontId, glyph, density,
+             (int)std::lround(cellWidth * 16.0f), (int)std::lround(cellHeight * 16.0f) };
+
+    auto it = m_templates.find(key);
+    if (it != m_templates.end()) return it->second;
+
+    GlyphTemplate& tmpl = m_templates[key];
+    if (m_font && density > 0) {
+        if (m_font->type() == FontType::Bitmap) buildBitmap(tmpl, glyph, density, cellWidth, cellHeight);
+        else buildVector(tmpl, glyph, density, cellWidth, cellHeight);
+    }
+
+    // Node-based map: pointer stays valid until clear()
+    tmpl.slot = m_slotCount++;
+    tmpl.gpuBase = m_gpuParticleCount;
+    m_gpuParticleCount += tmpl.count();
+    m_pending.push_back(&tmpl);
+    return tmpl;
+}
+
+void GlyphCache::buildBitmap(GlyphTemplate& out, uint32_t glyph, int density, float cellWidth, float cellHeight)
+{
+    int fw = m_font->width();
+    int fh = m_font->height();
+    float pixelW = cellWidth / (float)fw;
+    float pixelH = cellHeight / (float)fh;
+
+    float textSize = std::max(1.5f, pixelW * 0.65f);
+    out.particleSize = textSize;
+
+    // Block chars use the bitmap path but should NOT shimmer
+    bool isBlockChar = (glyph == 219);
+
+    for (int cy = 0; cy < fh; ++cy) {
+        for (int cx = 0; cx < fw; ++cx) {
+            if (!m_font->getPixel(glyph, cx, cy)) continue; // Background: BackgroundLayer
+
+            for (int i = 0; i < density; ++i) {
+                float jx = nextJitter() * pixelW * 0.1f * 0.5f;
+                float jy = nextJitter() * pixelH * 0.1f * 0.5f;
+                out.offsets.push_back(cx * pixelW + (pixelW * 0.5f) + jx);
+                out.offsets.push_back(cy * pixelH + (pixelH * 0.5f) + jy);
+                out.offsets.push_back(0.0f);
+                out.offsets.push_back(textSize);
+                out.flags.push_back(GLYPH_FG | (isBlockChar ? 0 : GLYPH_SHIMMER));
+            }
+        }
+    }
+
+    out.fgCount = (int)out.flags.size();
+}
+
+void GlyphCache::buildVector(GlyphTemplate& out, uint32_t glyph, int density, float cellWidth, float cellHeight)
+{
+    // UNIFIED RASTER-SCAN APPROACH
+    // 1. Scan virtual grid (12x18)
+    // 2. Check Point-to-Segment (FG)
+    // 3. Everything else is background (drawn by BackgroundLayer, no particles)
+    const int gridW = 12;
+    const int gridH = 18;
+
+    std::vector<VectorSegment> segments = m_font->getSegments(glyph);
+    bool isBlockChar = (glyph == 0x2588);
+
+    float size = std::max(1.5f, cellWidth / 12.0f * 0.9f);
+    out.particleSize = size;
+
+    for (int gy = 0; gy < gridH; ++gy) {
+        for (int gx = 0; gx < gridW; ++gx) {
+            float nx = (gx + 0.5f) / (float)gridW;
+            float ny = (gy + 0.5f) / (float)gridH;
+
+            bool isFg = isBlockChar;
+            if (!isFg) {
+                for (const auto& seg : segments) {
+                    float dx = seg.x2 - seg.x1;
+                    float dy = seg.y2 - seg.y1;
+                    float l2 = dx * dx + dy * dy;
+                    if (l2 == 0) {
+                        float d = (nx - seg.x1) * (nx - seg.x1) + (ny - seg.y1) * (ny - seg.y1);
+                        if (d < 0.005f) { isFg = true; break; }
+                    } else {
+                        float t = ((nx - seg.x1) * dx + (ny - seg.y1) * dy) / l2;
+                        t = std::max(0.0f, std::min(1.0f, t));
+                        float px = seg.x1 + t * dx;
+                        float py = seg.y1 + t * dy;
+                        float dist = (nx - px) * (nx - px) + (ny - py) * (ny - py);
+                        if (dist < 0.008f) { isFg = true; break; }
+                    }
+                }
+            }
+
+            if (!isFg) continue;
+
+            for (int i = 0; i < density; ++i) {
+                float jx = nextJitter() * 0.005f;
+                float jy = nextJitter() * 0.015f;
+                out.offsets.push_back(nx * cellWidth + jx);
+                out.offsets.push_back(ny * cellHeight + jy);
+                out.offsets.push_back(0.0f);
+                out.offsets.push_back(size);
+                out.flags.push_back(GLYPH_FG | GLYPH_SHIMMER);
+            }
+        }
+    }
+
+    out.fgCount = (int)out.flags.size();
+}
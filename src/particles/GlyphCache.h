@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "../fonts/FontAsset.h"
+
+// Per-particle flags stored alongside each template offset
+enum GlyphParticleFlag : uint8_t {
+    GLYPH_FG      = 1 << 0, // Text pixel (uses foreground color)
+    // 1 << 1 was GLYPH_BG: backgrounds are drawn by BackgroundLayer, templates hold text pixels only
+    GLYPH_SHIMMER = 1 << 2  // Pulse seed enabled
+};
+
+// Pre-rasterized particle layout of one glyph at one density / cell size.
+// Text pixels only (fgCount == count()); cell backgrounds are BackgroundLayer quads.
+struct GlyphTemplate {
+    std::vector<float> offsets;  // vec4 per particle: cell-relative x, y, 0, size
+    std::vector<uint8_t> flags;  // GlyphParticleFlag per particle
+    int fgCount = 0;
+    float particleSize = 0.0f;   // Same for every particle of a font at a given cell size
+
+    // GPU mirror location (see ParticleSystem GPU expansion)
+    int slot = -1;      // Index into the glyph table SSBO
+    int gpuBase = 0;    // First particle in the glyph particle SSBO
+
+    int count() const { return (int)flags.size(); }
+};
+
+// Lazily built cache of glyph templates, keyed by (font id, glyph, density, cell size).
+// Turns a changed cell into a copy + translate instead of a full re-rasterization.
+class GlyphCache
+{
+public:
+    GlyphCache();
+
+    // Font used by get() (shared cache: set before each lookup pass)
+    void setFont(const FontAsset* font, int fontId);
+    void clear();
+
+    // glyph is the code the font consumes: CP437 index for bitmap fonts, unicode for vector fonts
+    const GlyphTemplate& get(uint32_t glyph, int density, float cellWidth, float cellHeight);
+
+    size_t size() const { return m_templates.size(); }
+
+    // GPU upload bookkeeping: templates built since the last takePending()
+    int slotCount() const { return m_slotCount; }
+    int gpuParticleCount() const { return m_gpuParticleCount; }
+    std::vector<const GlyphTemplate*> takePending();
+
+private:
+    struct Key {
+        int fontId;
+        uint32_t glyph;
+        int density;
+        int cellW; // 1/16 px fixed point
+        int cellH;
+        bool operator==(const Key& o) const {
+            return fontId == o.fontId && glyph == o.glyph && density == o.density &&
+                   cellW == o.cellW && cellH == o.cellH;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            uint64_t h = (uint64_t)k.glyph * 0x9E3779B97F4A7C15ull;
+            h ^= ((uint64_t)k.fontId << 56) ^ ((uint64_t)k.density << 40);
+            h ^= ((uint64_t)(uint32_t)k.cellW << 20) ^ (uint64_t)(uint32_t)k.cellH;
+            return (size_t)(h ^ (h >> 29));
+        }
+    };
+
+    void buildBitmap(GlyphTemplate& out, uint32_t glyph, int density, float cellWidth, float cellHeight);
+    void buildVector(GlyphTemplate& out, uint32_t glyph, int density, float cellWidth, float cellHeight);
+    float nextJitter() { return m_jitterTable[(m_jitterIndex++) & (JITTER_SIZE - 1)]; }
+
+    static const int JITTER_SIZE = 8192;
+
+    const FontAsset* m_font = nullptr;
+    int m_fontId = 0;
+    std::unordered_map<Key, GlyphTemplate, KeyHash> m_templates;
+    std::vector<const GlyphTemplate*> m_pending;
+    int m_slotCount = 0;
+    int m_gpuParticleCount = 0;
+    std::vector<float> m_jitterTable; // Pre-computed random noise
+    int m_jitterIndex = 0;
+};
@@ -0,0 +1,69 @@
+#include "ParticleAllocator.h"
+
+void ParticleAllocator::reset(uint32_t limit)
+{
+    for (auto& list : m_free) list.clear();
+    m_highWater = 0;
+    m_live = 0;
+    m_limit = limit;
+}
+
+int ParticleAllocator::classFor(uint32_t count)
+{
+    int sizeClass = MIN_CLASS;
+    while (sizeClass < MAX_CLASS && (1u << sizeClass) < count) ++sizeClass;
+    return sizeClass;
+}
+
+bool ParticleAllocator::fits(const Block& block, uint32_t count)
+{
+    if (!block.valid()) return false;
+    return block.sizeClass == classFor(count);
+}
+
+bool ParticleAllocator::allocate(uint32_t count, Block& out)
+{
+    out = Block();
+    int sizeClass = classFor(count);
+
+    // 1. Reuse a released block of the same class
+    if (!m_free[sizeClass].empty()) {
+        out.first = m_free[sizeClass].back();
+        out.sizeClass = (uint8_t)sizeClass;
+        m_free[sizeClass].pop_back();
+    }
+    // 2. Bump from the high-water mark
+    else if (m_highWater + (1u << sizeClass) <= m_limit) {
+        out.first = m_highWater;
+        out.sizeClass = (uint8_t)sizeClass;
+        m_highWater += (1u << sizeClass);
+    }
+    // 3. Pool full: take a larger released block whole
+    else {
+        for (int c = sizeClass + 1; c <= MAX_CLASS; ++c) {
+            if (m_free[c].empty()) continue;
+            out.first = m_free[c].back();
+            out.sizeClass = (uint8_t)c;
+            m_free[c].pop_back();
+            break;
+        }
+        if (!out.valid()) return false;
+    }
+
+    m_live += out.capacity();
+    return true;
+}
+
+void ParticleAllocator::release(Block& block)
+{
+    if (!block.valid()) return;
+    m_live -= block.capacity();
+
+    // Top block: give it back to the bump region directly
+    if (block.first + block.capacity() == m_highWater) {
+        m_highWater = block.first;
+    } else {
+        m_free[block.sizeClass].push_back(block.first);
+    }
+    block = Block();
+}
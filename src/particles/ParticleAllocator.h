@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+// Size-class pool for per-cell particle ranges.
+// Each cell owns one power-of-two block sized to its glyph instead of a fixed
+// pixelsPerCell * density stride. Released blocks go to per-class free lists,
+// so a changed cell only touches its own range and neighbours never move.
+// SLACK: a block is the glyph's count rounded up to a power of two (at least
+// 1 << MIN_CLASS), so up to half of it can be hidden padding (e.g. 17 -> 32).
+// Only a full pool hands out a larger class (allocate step 3).
+class ParticleAllocator
+{
+public:
+    static const int MIN_CLASS = 4;  // 16 particles
+    static const int MAX_CLASS = 15; // 32768 particles
+    static const uint8_t NO_CLASS = 0xFF;
+
+    struct Block {
+        uint32_t first = 0;
+        uint8_t sizeClass = NO_CLASS;
+
+        bool valid() const { return sizeClass != NO_CLASS; }
+        uint32_t capacity() const { return valid() ? (1u << sizeClass) : 0; }
+    };
+
+    // Drop every block; limit caps the high-water mark (GPU buffer capacity)
+    void reset(uint32_t limit);
+
+    // Smallest class that holds count particles (count must be > 0)
+    static int classFor(uint32_t count);
+
+    // false when the pool is exhausted (block is left invalid)
+    bool allocate(uint32_t count, Block& out);
+    void release(Block& block);
+
+    // Keep a block only if count needs exactly its class
+    static bool fits(const Block& block, uint32_t count);
+
+    uint32_t highWater() const { return m_highWater; }
+    uint32_t limit() const { return m_limit; }
+    void setLimit(uint32_t limit) { m_limit = limit; } // Must stay >= highWater()
+    uint32_t liveParticles() const { return m_live; }
+
+private:
+    std::vector<uint32_t> m_free[MAX_CLASS + 1];
+    uint32_t m_highWater = 0;
+    uint32_t m_live = 0;
+    uint32_t m_limit = 0;
+};
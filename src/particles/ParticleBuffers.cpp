@@ -0,0 +1,114 @@
+#include "ParticleBuffers.h"
+#include <QDebug>
+#include <algorithm>
+
+// Underuse must last this long before the buffers are shrunk (avoids grow/shrink ping-pong)
+static const float SHRINK_AFTER_SECONDS = 10.0f;
+
+ParticleBuffers::ParticleBuffers()
+{
+}
+
+ParticleBuffers::~ParticleBuffers()
+{
+    destroy();
+}
+
+size_t ParticleBuffers::stride(Stream stream) const
+{
+    // COMPACT: motion 8 + shape 4 + target 4 + extra 4 + color 4 + state 1 bytes
+    // FLOAT:   motion 16 + shape 8 + target 8 + extra 16 + color 16 + state 1 bytes
+    if (stream == STATE) return sizeof(uint8_t);
+    if (m_compact) return (stream == MOTION) ? 2 * sizeof(uint32_t) : sizeof(uint32_t);
+    return (stream == SHAPE || stream == TARGET) ? 2 * sizeof(float) : 4 * sizeof(float);
+}
+
+size_t ParticleBuffers::bytesPerParticle() const
+{
+    size_t total = 0;
+    for (int s = 0; s < STREAM_COUNT; ++s) total += stride((Stream)s);
+    return total;
+}
+
+size_t ParticleBuffers::hotBytesPerParticle() const
+{
+    return stride(MOTION) + stride(TARGET) + stride(STATE);
+}
+
+GLsizeiptr ParticleBuffers::bufferBytes(Stream stream, int capacity) const
+{
+    // Shaders address the state bytes as uint words: round up to whole words
+    GLsizeiptr bytes = (GLsizeiptr)capacity * stride(stream);
+    return (bytes + 3) & ~(GLsizeiptr)3;
+}
+
+void ParticleBuffers::create(bool compact, int capacity)
+{
+    if (!m_initialized) {
+        initializeOpenGLFunctions();
+        m_initialized = true;
+    }
+    destroy();
+    m_compact = compact;
+    m_capacity = capacity;
+    m_underusedSince = -1.0f;
+
+    glCreateBuffers(STREAM_COUNT, m_buffers);
+    for (int s = 0; s < STREAM_COUNT; ++s) {
+        glNamedBufferData(m_buffers[s], bufferBytes((Stream)s, capacity), nullptr, GL_DYNAMIC_DRAW);
+    }
+    // Every slot starts dead: physics never touches it before it is written
+    glClearNamedBufferData(m_buffers[STATE], GL_R8UI, GL_RED_INTEGER, GL_UNSIGNED_BYTE, nullptr);
+}
+
+void ParticleBuffers::resize(int capacity, int preserve)
+{
+    preserve = std::min(preserve, std::min(capacity, m_capacity));
+
+    GLuint resized[STREAM_COUNT] = {};
+    glCreateBuffers(STREAM_COUNT, resized);
+    for (int s = 0; s < STREAM_COUNT; ++s) {
+        GLsizeiptr elementBytes = (GLsizeiptr)stride((Stream)s);
+        glNamedBufferData(resized[s], bufferBytes((Stream)s, capacity), nullptr, GL_DYNAMIC_DRAW);
+        if (s == STATE) glClearNamedBufferData(resized[s], GL_R8UI, GL_RED_INTEGER, GL_UNSIGNED_BYTE, nullptr);
+        if (preserve > 0) {
+            glCopyNamedBufferSubData(m_buffers[s], resized[s], 0, 0, (GLsizeiptr)preserve * elementBytes);
+        }
+    }
+    glDeleteBuffers(STREAM_COUNT, m_buffers);
+
+    qDebug() << "PARTICLE BUFFERS:" << m_capacity << "->" << capacity << "particles ("
+             << (qint64)capacity * (qint64)bytesPerParticle() / (1024 * 1024) << "MB, copied" << preserve << ")";
+
+    for (int s = 0; s < STREAM_COUNT; ++s) m_buffers[s] = resized[s];
+    m_capacity = capacity;
+    m_underusedSince = -1.0f;
+}
+
+void ParticleBuffers::destroy()
+{
+    if (!m_initialized) return;
+    glDeleteBuffers(STREAM_COUNT, m_buffers);
+    for (GLuint& buffer : m_buffers) buffer = 0;
+    m_capacity = 0;
+}
+
+int ParticleBuffers::grownCapacity(int current, int needed)
+{
+    return std::max(fittedCapacity(needed), current + current / 2);
+}
+
+int ParticleBuffers::fittedCapacity(int used)
+{
+    return std::max(MIN_CAPACITY, used + used / 4);
+}
+
+bool ParticleBuffers::shouldShrink(int used, float now)
+{
+    if (m_capacity <= MIN_CAPACITY || (qint64)used * 4 >= m_capacity) {
+        m_underusedSince = -1.0f;
+        return false;
+    }
+    if (m_underusedSince < 0.0f) m_underusedSince = now;
+    return now - m_underusedSince >= SHRINK_AFTER_SECONDS;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QOpenGLFunctions_4_5_Core>
+#include <cstddef>
+#include <cstdint>
+
+// Owns the per-particle GL buffers of one pane, split by who reads them:
+//   hot  (physics pass): MOTION (position + velocity), TARGET, STATE
+//   cold (render only):  SHAPE (z, size), EXTRA, COLOR
+// Capacity follows the allocator high-water mark: grown geometrically with a
+// GPU-side copy of the live prefix, shrunk once usage stays low for a while.
+class ParticleBuffers : protected QOpenGLFunctions_4_5_Core
+{
+public:
+    // SSBO binding = stream index, except STATE (binding 16, shaders/particle_state.glsl)
+    enum Stream { MOTION = 0, SHAPE, TARGET, EXTRA, COLOR, STATE, STREAM_COUNT };
+    static const int STATE_BINDING = 16;
+
+    // One byte per particle in the STATE stream
+    enum ParticleState : uint8_t {
+        STATE_DEAD = 0,    // Hidden / unused slot of a cell block
+        STATE_MOVING = 1,  // Integrated every physics pass
+        STATE_SETTLED = 2  // At its target, skipped until rewritten
+    };
+
+    static const int MIN_CAPACITY = 65536;
+
+    ParticleBuffers();
+    ~ParticleBuffers(); // GL context must be current
+
+    void create(bool compact, int capacity);
+    // New buffers of capacity particles; the first preserve particles are copied on the GPU
+    void resize(int capacity, int preserve);
+    void destroy();
+
+    GLuint buffer(Stream stream) const { return m_buffers[stream]; }
+    int capacity() const { return m_capacity; }
+    bool compact() const { return m_compact; }
+    size_t stride(Stream stream) const;
+    size_t bytesPerParticle() const;
+    size_t hotBytesPerParticle() const; // Streams the physics pass reads
+
+    // Growth: at least 1.5x the old capacity, with 25% headroom over needed
+    static int grownCapacity(int current, int needed);
+    static int fittedCapacity(int used);
+
+    // Shrink policy: true once used stayed under a quarter of the capacity for
+    // SHRINK_AFTER_SECONDS (now = any monotonic clock in seconds)
+    bool shouldShrink(int used, float now);
+
+private:
+    GLsizeiptr bufferBytes(Stream stream, int capacity) const;
+
+    GLuint m_buffers[STREAM_COUNT] = {};
+    int m_capacity = 0;
+    bool m_compact = false;
+    bool m_initialized = false;
+    float m_underusedSince = -1.0f;
+};
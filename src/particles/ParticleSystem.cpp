@@ -1,73 +1,130 @@
 #include "ParticleSystem.h"
+#include "../renderer/GpuResourcePool.h"
 #include "../renderer/ShaderManager.h"
-#include "../fonts/ClassicFont.h"
-#include "../fonts/HighResFont.h"
-#include "../fonts/SegmentedFont.h"
 #include "FontData.h" // Keep for fallback if needed
 #include "../terminal/TerminalModel.h"
 #include <QRandomGenerator>
 #include <QDebug>
+#include <qfloat16.h>
 #include <cmath>
+#include <cstring>
+#include <cstdlib>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
 
-// GTX 1080 Ti Optimization: Hard cap
-static const int MAX_PARTICLES = 8000000; // Increased from 2M to support Density 50
+// Particle storage before the first grid is known (the total cap lives in GpuResourcePool)
+static const int INITIAL_PARTICLE_CAPACITY = ParticleBuffers::MIN_CAPACITY;
+
+// Point sprites only below this on-screen particle size (framebuffer px): bigger
+// sprites cost more fill than the quads they replace and hit point size limits
+static const float POINT_SPRITE_MAX_PX = 3.0f;
+
+// Scratch kept between updates (larger dirty sets, e.g. full rebuilds, are freed after upload)
+static const size_t SCRATCH_KEEP_PARTICLES = 65536;
+
+// Matches GLSL packHalf2x16 (a in the low 16 bits)
+static inline uint32_t packHalf2(float a, float b)
+{
+    qfloat16 halves[2] = { qfloat16(a), qfloat16(b) };
+    uint16_t bits[2];
+    memcpy(bits, halves, sizeof(bits));
+    return (uint32_t)bits[0] | ((uint32_t)bits[1] << 16);
+}
+
+// Matches GLSL packUnorm4x8 / GL_UNSIGNED_BYTE attributes (r in the low byte)
+static inline uint32_t packRGBA8(float r, float g, float b, float a)
+{
+    auto to8 = [](float v) { return (uint32_t)(std::max(0.0f, std::min(1.0f, v)) * 255.0f + 0.5f); };
+    return to8(r) | (to8(g) << 8) | (to8(b) << 16) | (to8(a) << 24);
+}
+
+// COLOR REFS: the RGBA8 color word carries a palette index in r (a = 0) or a truecolor (a = 255).
+// particle.vert resolves indices through the palette UBO, so palette/theme changes never regenerate.
+static inline uint32_t paletteRef(int idx)
+{
+    return (uint32_t)(idx & 0xFF);
+}
+
+static inline uint32_t trueColorRef(uint8_t r, uint8_t g, uint8_t b)
+{
+    return (uint32_t)r | ((uint32_t)g << 8) | ((uint32_t)b << 16) | 0xFF000000u;
+}
+
+// std140 layout of the Palette block in particle.vert: 256 colors + index 0 on text pixels
+static const int PALETTE_COLORS = 256;
+static const int PALETTE_TEXT_BLACK = 256;
+static const int PALETTE_ENTRIES = 257;
 
 ParticleSystem::ParticleSystem()
     : m_particleCount(0)
-    , m_maxParticles(MAX_PARTICLES)
     , m_vao(0)
     , m_width(100.0f)
     , m_height(100.0f)
 {
+    resetPalette();
 }
 
 ParticleSystem::~ParticleSystem()
 {
     // Cleanup GL resources
     glDeleteVertexArrays(1, &m_vao);
-    glDeleteBuffers(1, &m_posVbo);
-    glDeleteBuffers(1, &m_velVbo);
-    glDeleteBuffers(1, &m_targetVbo);
-    glDeleteBuffers(1, &m_extraVbo);
-    glDeleteBuffers(1, &m_colorVbo);
+    glDeleteVertexArrays(1, &m_pointVao);
+    releaseParticleBuffers();
     glDeleteBuffers(1, &m_baseQuadVbo);
+    glDeleteBuffers(1, &m_cellSsbo);
+    glDeleteBuffers(1, &m_dirtyCellSsbo);
+    glDeleteBuffers(1, &m_visibleSsbo);
+    glDeleteBuffers(1, &m_indirectBuffer);
+    glDeleteBuffers(1, &m_activeCellSsbo);
+    glDeleteBuffers(1, &m_cellRangeSsbo);
+    glDeleteBuffers(1, &m_cellMotionSsbo);
+    glDeleteBuffers(1, &m_activeIndirectBuffer);
+    for (GLsync& fence : m_motionFences) {
+        if (fence) glDeleteSync(fence);
+    }
+    glDeleteBuffers(1, &m_motionCounter);
+    glDeleteBuffers(1, &m_motionReadback);
+    glDeleteBuffers(1, &m_paletteUbo);
+    glDeleteBuffers(1, &m_frameUbo);
+    
+    if (m_pool) {
+        m_pool->resizeReservation(m_particleCapacity, 0);
+        GpuResourcePool::release(m_pool);
+    }
 }
 
 void ParticleSystem::init()
 {
     initializeOpenGLFunctions();
+    m_pool = GpuResourcePool::acquire();
+    m_particleCapacity = m_pool->resizeReservation(0, INITIAL_PARTICLE_CAPACITY);
+    m_layoutCompact = m_compactParticles;
+    m_cursor.init(m_pool);
+    m_background.init(m_pool);
+    m_splat.init(m_pool);
+    m_frameCache.init(m_pool);
     initShaders();
     initBuffers();
+    m_uploader.init();
     
     // Seed some initial particles (will be overwritten by terminal update)
     // seedParticles(24000); 
     
-    // Initialize Jitter Table (Optimization for high density)
-    m_jitterTable.resize(8192); // 8K samples
-    auto* gen = QRandomGenerator::global();
-    for(size_t i=0; i<m_jitterTable.size(); ++i) {
-        m_jitterTable[i] = (gen->generateDouble() - 0.5) * 2.0; // -1 to 1
-    }
-    
     // Force apply default theme to init color tints
     // Force apply default theme to init color tints
     setTheme(m_theme);
     
-    // Default Font
-    m_font = new ClassicFont(); 
-    m_fontId = 0; // Classic
-    qDebug() << "FONT INIT: Default to ClassicFont (8x8), ID:" << m_fontId;
+    // Font objects are shared with the other panes through the pool
+    m_font = m_pool->font(m_fontId); // Classic unless changed before init
+    qDebug() << "FONT INIT:" << m_font->name() << "ID:" << m_fontId;
 }
 
 void ParticleSystem::setFont(FontAsset* font)
 {
-    if (m_font && m_font != font) delete m_font;
-    m_font = font;
+    m_font = font; // Owned by the GpuResourcePool
     m_prevGrid.clear(); // Force rebuild
 }
 
@@ -78,51 +135,428 @@ void ParticleSystem::setFontById(int id) {
         qDebug() << "FONT CHANGE: Skipped (same ID)";
         return;
     }
-    
-    FontAsset* newFont = nullptr;
-    switch(id) {
-        case 1: 
-            newFont = new HighResFont(); 
-            qDebug() << "FONT CHANGE: Creating HighResFont (16x16)";
-            break;
-        case 2: 
-            newFont = new SegmentedFont(); 
-            qDebug() << "FONT CHANGE: Creating SegmentedFont (Vector)";
-            break;
-        case 3: 
-            newFont = new TechVectorFont(); 
-            qDebug() << "FONT CHANGE: Creating TechVectorFont (Futuristic)";
-            break;
-        case 4:
-            newFont = new ModernTermFont();
-            qDebug() << "FONT CHANGE: Creating ModernTermFont";
-            break;
-        case 5:
-            newFont = new CodeProFont();
-            qDebug() << "FONT CHANGE: Creating CodeProFont";
-            break;
-        case 6:
-            newFont = new CrtRetroFont();
-            qDebug() << "FONT CHANGE: Creating CrtRetroFont";
-            break;
-        case 0: 
-        default: 
-            newFont = new ClassicFont(); 
-            qDebug() << "FONT CHANGE: Creating ClassicFont (8x8)";
-            break;
-    }
-    setFont(newFont);
     m_fontId = id;
+    if (!m_pool) return; // Resolved in init()
+    
+    setFont(m_pool->font(id));
     qDebug() << "FONT CHANGE: Complete. New Font Type:" << (int)m_font->type() << "Size:" << m_font->width() << "x" << m_font->height();
 }
 
 void ParticleSystem::initShaders()
 {
-    m_renderProgram = ShaderManager::createProgram("Render", 
-        "shaders/particle.vert", "shaders/particle.frag");
+    QStringList defines;
+    if (m_layoutCompact) defines << "COMPACT_PARTICLES";
+    
+    // Visible list: the vertex stage pulls particles from SSBOs (bindings 0-4 + 9)
+    GLint vertexSsbos = 0;
+    glGetIntegerv(GL_MAX_VERTEX_SHADER_STORAGE_BLOCKS, &vertexSsbos);
+    m_compactProgram = nullptr;
+    if (vertexSsbos >= 6) {
+        m_compactProgram = m_pool->computeProgram("Compact",
+            "shaders/particle_compact.comp", defines);
+    }
+    m_useVisibleList = (m_compactProgram != nullptr);
+    m_visibleDirty = true;
+    
+    // Physics + render variants; expansion always writes the full stride
+    m_layoutDefines = defines;
+    if (m_useVisibleList) defines << "VISIBLE_LIST";
+    m_streamDefines = defines;
+    
+    // Active cells: physics only for cells whose particles are still moving
+    m_cellsProgram = m_pool->computeProgram("Cells",
+        "shaders/particle_cells.comp");
+    m_fullPhysics = true; // Wake every cell on the first active-cell frame
+    
+    m_variantValid = false;
+    selectShaderVariants();
+}
+
+void ParticleSystem::selectShaderVariants()
+{
+    // Style / theme / effect flags are compiled in, not branched on per particle or fragment
+    ShaderVariant physics;
+    physics.style = m_animationStyle;
+    ShaderVariant look;
+    look.theme = m_theme;
+    if (m_scanlineIntensity > 0.001f) look.flags |= ShaderVariant::SCANLINES;
+    if (m_bloom) look.flags |= ShaderVariant::BLOOM;
+    if (m_variantValid && physics == m_physicsVariant && look == m_lookVariant) return;
+    
+    m_physicsVariant = physics;
+    m_lookVariant = look;
+    m_variantValid = true;
+    m_cacheValid = false; // Cached pixels were drawn by the previous programs
+    
+    // Programs are compiled on first use of a combination and cached by the pool
+    QStringList physicsDefines = ShaderManager::variantDefines(physics);
+    QStringList lookDefines = ShaderManager::variantDefines(look);
+    
+    m_renderProgram = m_pool->program("Render", 
+        "shaders/particle.vert", "shaders/particle.frag", m_streamDefines + lookDefines);
+    
+    // Point sprites pull by gl_VertexID from the visible list (compiled once enabled)
+    m_pointProgram = nullptr;
+    if (m_pointSprites && m_useVisibleList) {
+        m_pointProgram = m_pool->program("RenderPoints",
+            "shaders/particle.vert", "shaders/particle.frag", QStringList(m_streamDefines) << "POINT_SPRITES" << lookDefines);
+    }
+    
+    // Frame cache layers: particles routed to their shimmer group's attachment
+    m_cacheProgram = nullptr;
+    if (m_frameCaching && m_frameCache.isAvailable()) {
+        m_cacheProgram = m_pool->program("RenderCache",
+            "shaders/particle.vert", "shaders/particle.frag", QStringList(m_streamDefines) << "FRAME_CACHE" << lookDefines);
+    }
+        
+    m_computeProgram = m_pool->computeProgram("Compute", 
+        "shaders/particle_compute.comp", m_streamDefines + physicsDefines);
         
-    m_computeProgram = ShaderManager::createComputeProgram("Compute", 
-        "shaders/particle_compute.comp");
+    m_expandProgram = m_pool->computeProgram("Expand",
+        "shaders/particle_expand.comp", m_layoutDefines + physicsDefines);
+    
+    m_cellPhysicsProgram = nullptr;
+    if (m_cellsProgram) {
+        m_cellPhysicsProgram = m_pool->computeProgram("CellPhysics",
+            "shaders/particle_compute.comp", QStringList(m_layoutDefines) << "ACTIVE_CELLS" << physicsDefines);
+    }
+    
+    m_cursor.selectVariant(lookDefines);
+    m_background.selectVariant(lookDefines);
+    if (m_splatRendering) m_splat.selectVariant(m_streamDefines, lookDefines);
+    else m_splat.selectVariant(QStringList(), QStringList()); // Not compiled while disabled
+}
+
+void ParticleSystem::writeFrameUniforms(float dt)
+{
+    FrameUniforms frame = {};
+    fillFrameUniforms(frame, dt);
+    uploadFrameUniforms(frame);
+}
+
+void ParticleSystem::fillFrameUniforms(FrameUniforms& frame, float dt) const
+{
+    memcpy(frame.projection, m_frameProjection.constData(), sizeof(frame.projection));
+    frame.resolution[0] = m_width;
+    frame.resolution[1] = m_height;
+    frame.cellSize[0] = m_gridCellWidth;
+    frame.cellSize[1] = m_gridCellHeight;
+    frame.colorTint[0] = m_colorTint.x();
+    frame.colorTint[1] = m_colorTint.y();
+    frame.colorTint[2] = m_colorTint.z();
+    frame.elapsedTime = m_elapsedTime;
+    frame.shockwave[0] = m_shockX;
+    frame.shockwave[1] = ringY(m_shockY);
+    frame.shockwave[2] = m_shockTime;
+    frame.deltaTime = dt;
+    for (int k = 0; k < 4; ++k) frame.selection[k] = m_selection[k];
+    for (int k = 0; k < 3; ++k) frame.link[k] = m_link[k];
+    frame.link[3] = -1;
+    frame.rowHead = m_rowHead;
+    frame.rows = m_gridRows;
+    frame.shimmerSpeed = m_shimmerSpeed;
+    frame.glowIntensity = m_glowIntensity;
+    frame.brightness = m_brightness;
+    frame.vibrance = m_vibrance;
+    frame.scanlineIntensity = m_scanlineIntensity;
+    frame.springK = m_springK;
+    frame.drag = m_drag;
+    frame.pointScale = m_zoomLevel * m_pixelRatio;
+    writeShimmer(frame);
+}
+
+void ParticleSystem::uploadFrameUniforms(const FrameUniforms& frame)
+{
+    glNamedBufferSubData(m_frameUbo, 0, sizeof(frame), &frame);
+    glBindBufferBase(GL_UNIFORM_BUFFER, 1, m_frameUbo);
+}
+
+void ParticleSystem::writeShimmer(FrameUniforms& frame) const
+{
+    // Every particle's shimmer seeds are its flag (extra.x = 0 / 1) and flicker = 0, so the
+    // glow pulse, sparkle, jitter and orbit are two per-frame values instead of
+    // sin / hash work repeated for each vertex of each particle
+    auto rand = [](float x, float y) {
+        float v = std::sin(x * 12.9898f + y * 78.233f) * 43758.5453f;
+        return v - std::floor(v);
+    };
+    float time = std::fmod(m_elapsedTime, 100.0f); // Precision wrap, as the shaders did
+    float speed = std::max(0.5f, m_shimmerSpeed);
+    
+    // Occasional sparkle (high frequency noise) at shimmer speeds above 2
+    float sparkle = (m_shimmerSpeed > 2.0f && rand(time * speed * 5.0f, 0.0f) > 0.95f) ? 0.5f : 0.0f;
+    float jitterX = (rand(time * 5.0f, 0.0f) - 0.5f) * 0.1f;
+    
+    for (int flag = 0; flag < 2; ++flag) {
+        // Organic pulse: 0.7 - 1.3, offset by the flag
+        frame.shimmer[flag][0] = 1.0f + std::sin(time * speed + flag * 10.0f) * 0.3f + sparkle;
+        frame.shimmer[flag][1] = jitterX;
+        frame.shimmer[flag][2] = (rand(time * 5.0f, (float)flag) - 0.5f) * 0.1f;
+        frame.shimmer[flag][3] = 0.0f;
+        
+        float orbit = m_elapsedTime * (m_shimmerSpeed + flag);
+        frame.orbit[flag * 2 + 0] = std::cos(orbit) * 0.02f;
+        frame.orbit[flag * 2 + 1] = std::sin(orbit) * 0.02f;
+    }
+}
+
+void ParticleSystem::setPointSprites(bool enabled)
+{
+    if (m_pointSprites == enabled) return;
+    m_pointSprites = enabled;
+    m_variantValid = false; // Point program is picked up by selectShaderVariants
+}
+
+void ParticleSystem::setSplatRendering(bool enabled)
+{
+    if (m_splatRendering == enabled) return;
+    m_splatRendering = enabled;
+    m_variantValid = false; // Splat programs are picked up by selectShaderVariants
+}
+
+void ParticleSystem::setFrameCaching(bool enabled)
+{
+    if (m_frameCaching == enabled) return;
+    m_frameCaching = enabled;
+    m_cacheValid = false;
+    m_cacheDamage = QRectF();
+    m_variantValid = false; // Cache program is picked up by selectShaderVariants
+}
+
+void ParticleSystem::damageCell(int col, int screenRow)
+{
+    if (!m_frameCaching || !m_cacheValid) return;
+    
+    // Styles other than the direct fly-in move particles across the screen: redraw everything
+    if (m_animationStyle != STYLE_NORMAL && m_animationStyle != STYLE_RAIN) {
+        m_cacheValid = false;
+        return;
+    }
+    
+    // Fly-in start (100 px radial / up to 400 px above for rain) plus spring overshoot and glow
+    QRectF cell(col * m_gridCellWidth, screenRow * m_gridCellHeight, m_gridCellWidth, m_gridCellHeight);
+    float rise = (m_animationStyle == STYLE_RAIN) ? 420.0f : 0.0f;
+    m_cacheDamage |= cell.adjusted(-160.0f, -160.0f - rise, 160.0f, 160.0f);
+}
+
+void ParticleSystem::setCompactParticles(bool enabled)
+{
+    m_compactParticles = enabled;
+}
+
+void ParticleSystem::applyParticleLayout()
+{
+    // Needs a current context: called from update paths, not from the UI setter
+    if (m_layoutCompact == m_compactParticles) return;
+    m_layoutCompact = m_compactParticles;
+    
+    releaseParticleBuffers();
+    initParticleBuffers();
+    initShaders();
+    
+    releaseScratch();
+    m_uploader.clear();
+    m_particleCount = 0;
+    m_visibleDirty = true;
+    m_prevGrid.clear(); // Force rebuild into the new layout
+    
+    qDebug() << "PARTICLE LAYOUT:" << (m_layoutCompact ? "compact" : "float")
+             << m_buffers.bytesPerParticle() << "bytes/particle (physics reads"
+             << m_buffers.hotBytesPerParticle() << ")";
+}
+
+size_t ParticleSystem::reserveScratch(size_t count)
+{
+    // Zeroed particles: velocity and unused channels start at 0
+    // (state 0 = dead)
+    size_t base = m_scratchCount;
+    m_scratchCount += count;
+    m_scratchState.resize(m_scratchCount, ParticleBuffers::STATE_DEAD);
+    if (m_layoutCompact) {
+        m_scratchPackedMotion.resize(m_scratchCount * 2, 0);
+        m_scratchPackedShape.resize(m_scratchCount, 0);
+        m_scratchPackedTarget.resize(m_scratchCount, 0);
+        m_scratchPackedExtra.resize(m_scratchCount, 0);
+        m_scratchPackedColor.resize(m_scratchCount, 0);
+    } else {
+        m_scratchMotion.resize(m_scratchCount * 4, 0.0f);
+        m_scratchShape.resize(m_scratchCount * 2, 0.0f);
+        m_scratchTarget.resize(m_scratchCount * 2, 0.0f);
+        m_scratchExtra.resize(m_scratchCount * 4, 0.0f);
+        m_scratchColor.resize(m_scratchCount * 4, 0.0f);
+    }
+    return base;
+}
+
+void ParticleSystem::releaseScratch()
+{
+    // Keep a small working set for typing; give back what a full rebuild used
+    bool trim = m_scratchCount > SCRATCH_KEEP_PARTICLES;
+    auto drop = [trim](auto& vec) {
+        vec.clear();
+        if (trim) vec.shrink_to_fit();
+    };
+    drop(m_scratchMotion);
+    drop(m_scratchShape);
+    drop(m_scratchTarget);
+    drop(m_scratchExtra);
+    drop(m_scratchColor);
+    
+    drop(m_scratchPackedMotion);
+    drop(m_scratchPackedShape);
+    drop(m_scratchPackedTarget);
+    drop(m_scratchPackedExtra);
+    drop(m_scratchPackedColor);
+    drop(m_scratchState);
+    m_scratchCount = 0;
+}
+
+void ParticleSystem::writeParticle(size_t idx, float tx, float ty, float size, float dx, float dy, float dz,
+                                   uint32_t color, float pulse, bool text)
+{
+    // Already on target (no fly-in): physics skips it from the start
+    bool onTarget = (dx == 0.0f && dy == 0.0f);
+    m_scratchState[idx] = onTarget ? ParticleBuffers::STATE_SETTLED : ParticleBuffers::STATE_MOVING;
+    
+    if (m_layoutCompact) {
+        uint32_t qx = (uint32_t)std::max(0.0f, std::min(65534.0f, tx * 8.0f + 0.5f));
+        uint32_t qy = (uint32_t)std::max(0.0f, std::min(65534.0f, ty * 8.0f + 0.5f));
+        m_scratchPackedTarget[idx] = qx | (qy << 16);
+        m_scratchPackedMotion[idx*2 + 0] = packHalf2(dx, dy); // Velocity word stays 0
+        m_scratchPackedShape[idx] = packHalf2(dz, size);
+        m_scratchPackedColor[idx] = color;
+        m_scratchPackedExtra[idx] = packRGBA8(pulse, 0.0f, 0.0f, text ? 1.0f : 0.0f);
+        return;
+    }
+    
+    m_scratchTarget[idx*2 + 0] = tx;
+    m_scratchTarget[idx*2 + 1] = ty;
+    m_scratchMotion[idx*4 + 0] = tx + dx;
+    m_scratchMotion[idx*4 + 1] = ty + dy;
+    
+    // CRITICAL FIX: Set the size for visibility
+    m_scratchShape[idx*2 + 0] = dz;
+    m_scratchShape[idx*2 + 1] = size;
+    
+    // Same color ref as the compact word, unpacked (particle.vert decodes both alike)
+    float* rgba = &m_scratchColor[idx*4];
+    for (int k = 0; k < 4; ++k) rgba[k] = ((color >> (k * 8)) & 0xFF) / 255.0f;
+    
+    m_scratchExtra[idx*4 + 0] = pulse;
+    m_scratchExtra[idx*4 + 3] = text ? 1.0f : 0.0f; // Link highlight recolors text pixels only
+}
+
+void ParticleSystem::hideParticle(size_t idx)
+{
+    // Scratch is zeroed: dead state, size 0 and velocity 0 are already set
+    if (m_layoutCompact) {
+        m_scratchPackedTarget[idx] = 0xFFFF;
+        return;
+    }
+    m_scratchTarget[idx*2 + 0] = -10000.0f;
+}
+
+bool ParticleSystem::allocateCellBlock(int count, ParticleAllocator::Block& block)
+{
+    if (!m_allocator.allocate(count, block)) {
+        // The limit covers the whole shared budget: the buffers grow after the pass
+        if (!m_poolFullWarned) {
+            qWarning() << "PARTICLE POOL FULL:" << m_allocator.highWater() << "of" << m_allocator.limit() << "- cells skipped";
+            m_poolFullWarned = true;
+        }
+        return false;
+    }
+    m_particleCount = m_allocator.highWater();
+    return true;
+}
+
+void ParticleSystem::releaseCellBlock(ParticleAllocator::Block& block)
+{
+    if (!block.valid()) return;
+    uint32_t first = block.first;
+    uint32_t count = block.capacity();
+    
+    // No CPU copy: clear state (dead), target (hidden) and shape (size 0) directly on the GPU
+    GLintptr shapeStride = (GLintptr)m_buffers.stride(ParticleBuffers::SHAPE);
+    GLintptr targetStride = (GLintptr)m_buffers.stride(ParticleBuffers::TARGET);
+    glClearNamedBufferSubData(m_stateVbo, GL_R8UI, first, count, GL_RED_INTEGER, GL_UNSIGNED_BYTE, nullptr);
+    if (m_layoutCompact) {
+        const GLuint hidden = 0xFFFF;
+        glClearNamedBufferSubData(m_targetVbo, GL_R32UI, first * targetStride, count * targetStride,
+                                  GL_RED_INTEGER, GL_UNSIGNED_INT, &hidden);
+        glClearNamedBufferSubData(m_shapeVbo, GL_R32UI, first * shapeStride, count * shapeStride,
+                                  GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    } else {
+        const float hidden[2] = { -10000.0f, 0.0f };
+        glClearNamedBufferSubData(m_targetVbo, GL_RG32F, first * targetStride, count * targetStride,
+                                  GL_RG, GL_FLOAT, hidden);
+        glClearNamedBufferSubData(m_shapeVbo, GL_RG32F, first * shapeStride, count * shapeStride,
+                                  GL_RG, GL_FLOAT, nullptr);
+    }
+    
+    m_allocator.release(block);
+    m_particleCount = m_allocator.highWater();
+}
+
+void ParticleSystem::setGpuExpansion(bool enabled)
+{
+    if (m_gpuExpansion == enabled) return;
+    m_gpuExpansion = enabled;
+    m_prevGrid.clear(); // Force rebuild through the new path
+}
+
+void ParticleSystem::ensureBufferCapacity(GLuint& buffer, int& capacity, int needed, int stride)
+{
+    if (buffer && needed <= capacity) return;
+    
+    // Grow geometrically, preserving existing contents
+    int newCapacity = std::max(std::max(needed, capacity * 2), 1024);
+    GLuint newBuffer = 0;
+    glCreateBuffers(1, &newBuffer);
+    glNamedBufferData(newBuffer, (GLsizeiptr)newCapacity * stride, nullptr, GL_DYNAMIC_DRAW);
+    if (buffer) {
+        if (capacity > 0) glCopyNamedBufferSubData(buffer, newBuffer, 0, 0, (GLsizeiptr)capacity * stride);
+        glDeleteBuffers(1, &buffer);
+    }
+    buffer = newBuffer;
+    capacity = newCapacity;
+}
+
+void ParticleSystem::dispatchExpansion(int cols, float charWidth, float charHeight)
+{
+    m_pool->uploadGlyphTemplates();
+    
+    // Cell records (spans marked by queueCell) + dirty list, through the upload engine
+    ensureBufferCapacity(m_cellSsbo, m_cellCapacity, (int)(m_cellData.size() / 4), 4 * sizeof(uint32_t));
+    flushUploads();
+    if (m_dirtyCells.empty()) return;
+    
+    int dirtyCount = (int)m_dirtyCells.size();
+    
+    m_expandProgram->bind();
+    m_expandProgram->setUniformValue("uDirtyCount", dirtyCount);
+    m_expandProgram->setUniformValue("uCols", cols);
+    m_expandProgram->setUniformValue("uMaxParticles", m_particleCount);
+    m_expandProgram->setUniformValue("uCellSize", QVector2D(charWidth, charHeight));
+    m_expandProgram->setUniformValue("uSeed", (GLuint)(++m_expandSeed * 0x9E3779B9u));
+    
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_motionVbo);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_shapeVbo);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_targetVbo);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_extraVbo);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, m_colorVbo);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ParticleBuffers::STATE_BINDING, m_stateVbo);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, m_cellSsbo);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, m_dirtyCellSsbo);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 7, m_pool->glyphTableSsbo());
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 8, m_pool->glyphParticleSsbo());
+    
+    // One workgroup per dirty cell (2D to stay under the per-dimension limit)
+    int groupsX = std::min(dirtyCount, 65535);
+    int groupsY = (dirtyCount + groupsX - 1) / groupsX;
+    glDispatchCompute(groupsX, groupsY, 1);
+    
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
 }
 
 void ParticleSystem::initBuffers()
@@ -147,30 +581,99 @@ void ParticleSystem::initBuffers()
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
 
     // 3. Instance Buffers
+    initParticleBuffers();
     
-    glGenBuffers(1, &m_posVbo);
-    glBindBuffer(GL_ARRAY_BUFFER, m_posVbo);
-    glBufferData(GL_ARRAY_BUFFER, m_maxParticles * 4 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    // 4. Indirect commands (draw 4 verts x 0 instances, dispatch 0 groups, 0 points until compacted)
+    const GLuint emptyCommands[12] = { 4, 0, 0, 0, 0, 1, 1, 0, 0, 1, 0, 0 };
+    glCreateBuffers(1, &m_indirectBuffer);
+    glNamedBufferData(m_indirectBuffer, sizeof(emptyCommands), emptyCommands, GL_DYNAMIC_DRAW);
     
-    // Attribute 1: Instance Pos (vec3) - we'll just take xyz from vec4
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 4 * sizeof(float), nullptr);
-    glVertexAttribDivisor(1, 1); // Per instance
-
-    // Velocities
-    glGenBuffers(1, &m_velVbo);
-    glBindBuffer(GL_ARRAY_BUFFER, m_velVbo);
-    glBufferData(GL_ARRAY_BUFFER, m_maxParticles * 4 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    // Active-cell dispatch (x groups, 1, 1, active count)
+    const GLuint emptyDispatch[4] = { 0, 1, 1, 0 };
+    glCreateBuffers(1, &m_activeIndirectBuffer);
+    glNamedBufferData(m_activeIndirectBuffer, sizeof(emptyDispatch), emptyDispatch, GL_DYNAMIC_DRAW);
     
-    // Target Positions
-    glGenBuffers(1, &m_targetVbo);
-    glBindBuffer(GL_ARRAY_BUFFER, m_targetVbo);
-    glBufferData(GL_ARRAY_BUFFER, m_maxParticles * 4 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    // Moving-particle counter + readback ring (idle detection)
+    const GLuint zero = 0;
+    glCreateBuffers(1, &m_motionCounter);
+    glNamedBufferStorage(m_motionCounter, sizeof(GLuint), &zero, 0);
+    glCreateBuffers(1, &m_motionReadback);
+    glNamedBufferStorage(m_motionReadback, MOTION_READBACK_SLOTS * sizeof(GLuint), nullptr, GL_CLIENT_STORAGE_BIT);
+    
+    // Palette UBO (filled on the first render)
+    glCreateBuffers(1, &m_paletteUbo);
+    glNamedBufferData(m_paletteUbo, PALETTE_ENTRIES * 4 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    m_paletteDirty = true;
+    
+    // Frame UBO (shaders/frame.glsl), rewritten before every physics and render pass
+    glCreateBuffers(1, &m_frameUbo);
+    glNamedBufferData(m_frameUbo, sizeof(FrameUniforms), nullptr, GL_DYNAMIC_DRAW);
 
-    // Extra Data
-    glGenBuffers(1, &m_extraVbo);
-    glBindBuffer(GL_ARRAY_BUFFER, m_extraVbo);
-    glBufferData(GL_ARRAY_BUFFER, m_maxParticles * 4 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    // Point sprites read nothing from attributes: an empty VAO (gl_VertexID only)
+    glCreateVertexArrays(1, &m_pointVao);
+
+    glBindVertexArray(0);
+}
+
+void ParticleSystem::initParticleBuffers()
+{
+    m_buffers.create(m_layoutCompact, m_particleCapacity);
+    bindParticleBuffers();
+}
+
+void ParticleSystem::bindParticleBuffers()
+{
+    // Handles change on every resize: re-point the instance attributes
+    m_motionVbo = m_buffers.buffer(ParticleBuffers::MOTION);
+    m_targetVbo = m_buffers.buffer(ParticleBuffers::TARGET);
+    m_stateVbo = m_buffers.buffer(ParticleBuffers::STATE);
+    m_shapeVbo = m_buffers.buffer(ParticleBuffers::SHAPE);
+    m_extraVbo = m_buffers.buffer(ParticleBuffers::EXTRA);
+    m_colorVbo = m_buffers.buffer(ParticleBuffers::COLOR);
+    
+    glBindVertexArray(m_vao);
+    
+    if (m_layoutCompact) {
+        // Attribute 1: Packed offset from target (uint, first word of the motion stream)
+        glBindBuffer(GL_ARRAY_BUFFER, m_motionVbo);
+        glEnableVertexAttribArray(1);
+        glVertexAttribIPointer(1, 1, GL_UNSIGNED_INT, 2 * sizeof(uint32_t), nullptr);
+        glVertexAttribDivisor(1, 1);
+        
+        // Attribute 2: Target (uint, 2 x uint16 fixed point)
+        glBindBuffer(GL_ARRAY_BUFFER, m_targetVbo);
+        glEnableVertexAttribArray(2);
+        glVertexAttribIPointer(2, 1, GL_UNSIGNED_INT, sizeof(uint32_t), nullptr);
+        glVertexAttribDivisor(2, 1);
+        
+        // Attribute 6: Shape (uint, half2 z + size)
+        glBindBuffer(GL_ARRAY_BUFFER, m_shapeVbo);
+        glEnableVertexAttribArray(6);
+        glVertexAttribIPointer(6, 1, GL_UNSIGNED_INT, sizeof(uint32_t), nullptr);
+        glVertexAttribDivisor(6, 1);
+        
+        // Attribute 4: Extra (RGBA8 normalized)
+        glBindBuffer(GL_ARRAY_BUFFER, m_extraVbo);
+        glEnableVertexAttribArray(4);
+        glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, nullptr);
+        glVertexAttribDivisor(4, 1);
+        
+        // Attribute 3: Color (RGBA8 normalized)
+        glBindBuffer(GL_ARRAY_BUFFER, m_colorVbo);
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, nullptr);
+        glVertexAttribDivisor(3, 1);
+        
+        glDisableVertexAttribArray(5); // Float-only target attribute
+        glBindVertexArray(0);
+        return;
+    }
+    
+    // Attribute 1: Instance Pos (vec2) - xy of the motion stream (velocity in zw is skipped)
+    glBindBuffer(GL_ARRAY_BUFFER, m_motionVbo);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), nullptr);
+    glVertexAttribDivisor(1, 1); // Per instance
     
     // Attribute 4: Extra (vec4)
     glEnableVertexAttribArray(4);
@@ -178,44 +681,80 @@ void ParticleSystem::initBuffers()
     glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
     glVertexAttribDivisor(4, 1);
 
-    // Colors
-    glGenBuffers(1, &m_colorVbo);
-    glBindBuffer(GL_ARRAY_BUFFER, m_colorVbo);
-    glBufferData(GL_ARRAY_BUFFER, m_maxParticles * 4 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
-    
     // Attribute 3: Color (vec4)
     glEnableVertexAttribArray(3);
     glBindBuffer(GL_ARRAY_BUFFER, m_colorVbo);
     glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
     glVertexAttribDivisor(3, 1);
 
-    // Attribute 2: Size (float) - reuse w component of Pos
+    // Attribute 2: Shape (vec2: z, size)
     glEnableVertexAttribArray(2);
-    glBindBuffer(GL_ARRAY_BUFFER, m_posVbo); 
-    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(3*sizeof(float))); // Offset to w
+    glBindBuffer(GL_ARRAY_BUFFER, m_shapeVbo); 
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
     glVertexAttribDivisor(2, 1);
 
+    // Attribute 5: Target (vec2) - row ring shift follows the target row
+    glEnableVertexAttribArray(5);
+    glBindBuffer(GL_ARRAY_BUFFER, m_targetVbo);
+    glVertexAttribPointer(5, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+    glVertexAttribDivisor(5, 1);
+    
+    glDisableVertexAttribArray(6); // Compact-only shape attribute
+
     glBindVertexArray(0);
 }
 
+void ParticleSystem::resizeParticleBuffers(int capacity, int preserve)
+{
+    m_particleCapacity = m_pool->resizeReservation(m_particleCapacity, capacity);
+    m_buffers.resize(m_particleCapacity, preserve);
+    bindParticleBuffers();
+}
+
+void ParticleSystem::fitParticleBuffers(bool fullRebuild, int preserve)
+{
+    int needed = (int)m_allocator.highWater();
+    
+    if (needed > m_particleCapacity) {
+        // GROW: the allocator limit was this pane's reservation + the free budget, so the grant covers needed
+        resizeParticleBuffers(ParticleBuffers::grownCapacity(m_particleCapacity, needed), preserve);
+    } else if (fullRebuild && m_particleCapacity > ParticleBuffers::fittedCapacity(needed) * 2) {
+        // SHRINK: a full pass rewrites every block, nothing to copy
+        resizeParticleBuffers(ParticleBuffers::fittedCapacity(needed), 0);
+    }
+}
+
+void ParticleSystem::releaseParticleBuffers()
+{
+    m_buffers.destroy();
+    m_motionVbo = m_targetVbo = m_stateVbo = m_shapeVbo = m_extraVbo = m_colorVbo = 0;
+}
+
 void ParticleSystem::seedParticles(int count)
 {
-    m_particleCount = std::min(count, m_maxParticles);
+    if (m_layoutCompact) return; // Debug seeding only supports the float layout
+    m_particleCount = std::min(count, m_particleCapacity);
+    m_visibleDirty = true;
     
-    std::vector<float> positions(m_maxParticles * 4);
-    std::vector<float> velocities(m_maxParticles * 4);
-    std::vector<float> colors(m_maxParticles * 4);
+    std::vector<float> motions(m_particleCount * 4);
+    std::vector<float> targets(m_particleCount * 2);
+    std::vector<float> shapes(m_particleCount * 2);
+    std::vector<float> colors(m_particleCount * 4);
+    std::vector<uint8_t> states(m_particleCount, ParticleBuffers::STATE_MOVING);
     
     auto* gen = QRandomGenerator::global();
     
     for(int i=0; i<m_particleCount; ++i) {
-        positions[i*4 + 0] = gen->bounded(m_width);
-        positions[i*4 + 1] = gen->bounded(m_height);
-        positions[i*4 + 2] = 0.0f; 
-        positions[i*4 + 3] = 4.0f; 
+        float x = gen->bounded(m_width);
+        float y = gen->bounded(m_height);
+        motions[i*4 + 0] = x;
+        motions[i*4 + 1] = y;
+        motions[i*4 + 2] = (gen->generateDouble() - 0.5) * 10.0;
+        motions[i*4 + 3] = (gen->generateDouble() - 0.5) * 10.0;
         
-        velocities[i*4 + 0] = (gen->generateDouble() - 0.5) * 10.0;
-        velocities[i*4 + 1] = (gen->generateDouble() - 0.5) * 10.0;
+        targets[i*2 + 0] = x;
+        targets[i*2 + 1] = y;
+        shapes[i*2 + 1] = 4.0f;
         
         colors[i*4 + 0] = 1.0f; 
         colors[i*4 + 1] = 0.7f; 
@@ -223,26 +762,19 @@ void ParticleSystem::seedParticles(int count)
         colors[i*4 + 3] = 1.0f; 
     }
     
-    glBindBuffer(GL_ARRAY_BUFFER, m_posVbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, positions.size() * sizeof(float), positions.data());
-    
-    glBindBuffer(GL_ARRAY_BUFFER, m_velVbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, velocities.size() * sizeof(float), velocities.data());
-    
-    glBindBuffer(GL_ARRAY_BUFFER, m_targetVbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, positions.size() * sizeof(float), positions.data());
-    
-    glBindBuffer(GL_ARRAY_BUFFER, m_colorVbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, colors.size() * sizeof(float), colors.data());
+    glNamedBufferSubData(m_motionVbo, 0, motions.size() * sizeof(float), motions.data());
+    glNamedBufferSubData(m_targetVbo, 0, targets.size() * sizeof(float), targets.data());
+    glNamedBufferSubData(m_shapeVbo, 0, shapes.size() * sizeof(float), shapes.data());
+    glNamedBufferSubData(m_colorVbo, 0, colors.size() * sizeof(float), colors.data());
+    glNamedBufferSubData(m_stateVbo, 0, states.size(), states.data());
 }
 
-void ParticleSystem::updateParticlesFromTerminal(const TerminalModel& model, int cursorX, int cursorY, bool cursorVisible,
-                                                  int selStartCol, int selStartRow, int selEndCol, int selEndRow,
-                                                  int linkRow, int linkStart, int linkEnd)
+void ParticleSystem::updateParticlesFromTerminal(const TerminalModel& model)
 {
     // ---------------------------------------------------------
     // OPTIMIZED GRID UPDATE (Fly-In & Partial Updates)
     // ---------------------------------------------------------
+    applyParticleLayout();
 
     int cols = model.cols();
     int rows = model.rows();
@@ -251,61 +783,72 @@ void ParticleSystem::updateParticlesFromTerminal(const TerminalModel& model, int
     if (cols == 0 || rows == 0) return;
 
     // Check if we need to full-rebuild (Resize or Init)
-    int particlesPerPixel = m_density;
+    // Cells own variable-size particle blocks (ParticleAllocator), so density
+    // and font only matter through the glyph templates.
+    bool gpuExpand = m_gpuExpansion && m_expandProgram;
+    m_dirtyCells.clear();
     
-    // CRITICAL: Calculate pixels per cell based on ACTUAL font size
-    // Bitmap fonts use their grid, Vector fonts use 64 (standardized to 8x8 equivalent)
-    // BUG FIX: Vector fonts were running out of particles. Bump default to higher value (e.g. 256 = 16x16 equiv)
-    int pixelsPerCell = 256; 
-    if (m_font && m_font->type() == FontType::Bitmap) {
-        pixelsPerCell = m_font->width() * m_font->height();
-        if (pixelsPerCell < 64) pixelsPerCell = 64; // Min cap
+    // Shared glyph cache: a trim (by any pane) invalidates every pane's slots
+    m_pool->trimGlyphCache();
+    if (m_glyphGeneration != m_pool->glyphGeneration()) {
+        m_glyphGeneration = m_pool->glyphGeneration();
+        m_prevGrid.clear();
     }
+    GlyphCache& glyphCache = m_pool->glyphCache();
+    glyphCache.setFont(m_font, m_fontId);
 
-    
-    int particlesPerCell = pixelsPerCell * particlesPerPixel;
-    size_t totalParticles = (size_t)cols * rows * particlesPerCell;
-    
-    // Check if density changed or grid changed
-    // IMPORTANT: Density change alters stride (particlesPerCell), so we MUST rebuild if it changes.
     bool fullRebuild = (cols != m_gridCols || rows != m_gridRows || 
                        m_density != m_gridDensity ||
-                       totalParticles > m_posData.size()/4 || 
                        m_prevGrid.size() != (size_t)(cols * rows));
 
     if (fullRebuild) {
-        qDebug() << "GRID RESIZE/INIT: " << cols << "x" << rows << " Particles:" << totalParticles << " Density:" << m_density;
+        qDebug() << "GRID RESIZE/INIT: " << cols << "x" << rows << " Density:" << m_density;
+        // DEFRAG keeps the char history so repacking does not replay the fly-in
+        if (!m_defragPending || m_prevChars.size() != (size_t)(cols * rows)) {
+            m_prevChars.assign(cols * rows, 0); // Reset chars
+        }
+        m_defragPending = false;
         m_gridCols = cols;
         m_gridRows = rows;
         m_gridDensity = m_density;
         m_prevGrid.assign(cols * rows, 0xFFFFFFFF); // Force update all
-        m_prevChars.assign(cols * rows, 0); // Reset chars
-        
-        size_t floatCount = totalParticles * 4;
-        
-        if (totalParticles > (size_t)m_maxParticles) {
-            totalParticles = m_maxParticles;
-            floatCount = totalParticles * 4;
-        }
-
-        m_posData.resize(floatCount);
-        m_velData.resize(floatCount);
-        m_targetData.resize(floatCount);
-        m_colorData.resize(floatCount);
-        m_extraData.resize(floatCount);
+        m_cacheValid = false;
+        m_cellData.assign((size_t)cols * rows * 4, 0);
+        m_background.resize(cols, rows);
         
-        m_particleCount = totalParticles;
+        // Fresh pool: every cell allocates again in grid order
+        // Limit: everything this pane could get from the shared budget, trimmed after the pass
+        m_allocator.reset(m_particleCapacity + m_pool->availableParticles());
+        m_cellBlocks.assign((size_t)cols * rows, ParticleAllocator::Block());
+        m_poolFullWarned = false;
+        releaseScratch();
+        m_particleCount = 0;
+        m_uploader.clear();
         
-        std::fill(m_posData.begin(), m_posData.end(), 0.0f);
-        std::fill(m_velData.begin(), m_velData.end(), 0.0f);
-        std::fill(m_targetData.begin(), m_targetData.end(), 0.0f);
-        std::fill(m_colorData.begin(), m_colorData.end(), 0.0f);
-        std::fill(m_extraData.begin(), m_extraData.end(), 0.0f);
-        
-        // Upload ZEROED buffers
-        glBindBuffer(GL_ARRAY_BUFFER, m_posVbo);
-        glBufferData(GL_ARRAY_BUFFER, m_maxParticles * 4 * sizeof(float), nullptr, GL_DYNAMIC_DRAW); 
-        glBufferSubData(GL_ARRAY_BUFFER, 0, floatCount * sizeof(float), m_posData.data());
+        // Cell -> range table and motion flags (every cell starts awake)
+        int cellCount = cols * rows;
+        m_cellRanges.assign(cellCount, 0xFFFFFFFF);
+        m_uploader.markDirty(1u << STREAM_CELL_RANGES, 0, cellCount);
+        ensureBufferCapacity(m_cellRangeSsbo, m_cellRangeCapacity, cellCount, sizeof(uint32_t));
+        ensureBufferCapacity(m_activeCellSsbo, m_activeCellCapacity, cellCount, sizeof(uint32_t));
+        ensureBufferCapacity(m_cellMotionSsbo, m_cellMotionCapacity, cellCount, sizeof(uint32_t));
+        wakeAllCells();
+    } else {
+        // Room to grow into: this pane's buffers + whatever the other panes left in the budget
+        m_allocator.setLimit(std::max(m_allocator.highWater(),
+                                      (uint32_t)(m_particleCapacity + m_pool->availableParticles())));
+    }
+    int preserved = m_particleCount; // Particles already on the GPU (copied when the buffers grow)
+    
+    // ROW RING: a scroll only rotates the screen -> physical row mapping. Rows that
+    // scroll into view land on the rows that left it, whose cached signatures no
+    // longer match, so only they regenerate (O(cols) per scrolled line).
+    qint64 scrolled = model.scrollPosition() - m_scrollPosition;
+    m_scrollPosition = model.scrollPosition();
+    if (fullRebuild) {
+        m_rowHead = 0;
+    } else if (scrolled != 0 && std::llabs(scrolled) < rows) {
+        m_rowHead = (int)(((m_rowHead + scrolled) % rows + rows) % rows);
     }
     
     auto mapUnicodeToCP437 = [](uint32_t u) -> uint8_t {
@@ -327,64 +870,52 @@ void ParticleSystem::updateParticlesFromTerminal(const TerminalModel& model, int
     float charHeight = 18.0f;
     if (cols > 0) charWidth = m_width / cols;
     if (rows > 0) charHeight = m_height / rows;
+    m_gridCellWidth = charWidth;
+    m_gridCellHeight = charHeight;
 
     auto* gen = QRandomGenerator::global();
     
-    size_t minChangeIdx = 0xFFFFFFFF;
-    size_t maxChangeIdx = 0;
+    // CURSOR LAYER: block glyph at the current cell size (uploaded only when it changes)
+    bool bitmapFont = (m_font->type() == FontType::Bitmap);
+    const GlyphTemplate& blockGlyph = glyphCache.get(bitmapFont ? 219 : 0x2588, m_density, charWidth, charHeight);
+    m_cursor.setGlyph(blockGlyph, m_glyphGeneration);
+    m_particleSize = blockGlyph.particleSize; // Point-sprite threshold (uniform per font + cell size)
+    
+    // GPU expansion: queue a compact cell record instead of particles
+    auto setCellRange = [this](int gridIdx, const ParticleAllocator::Block& block) {
+        uint32_t range = block.valid() ? ((block.first & 0x07FFFFFF) | ((uint32_t)block.sizeClass << 27)) : 0xFFFFFFFF;
+        if (m_cellRanges[gridIdx] == range) return;
+        m_cellRanges[gridIdx] = range;
+        m_uploader.markDirty(1u << STREAM_CELL_RANGES, gridIdx, 1);
+    };
+    auto queueCell = [this](int gridIdx, uint32_t slot, uint32_t attr, uint32_t fg,
+                            const ParticleAllocator::Block& block) {
+        m_cellData[gridIdx*4 + 0] = (slot & 0x00FFFFFF) | (attr << 24);
+        m_cellData[gridIdx*4 + 1] = fg;
+        m_cellData[gridIdx*4 + 2] = 0;
+        m_cellData[gridIdx*4 + 3] = (block.first & 0x07FFFFFF) | ((uint32_t)block.sizeClass << 27);
+        m_dirtyCells.push_back((uint32_t)gridIdx);
+        m_uploader.markDirty(1u << STREAM_CELLS, gridIdx, 1);
+    };
 
     for (int r = 0; r < rows; ++r) {
         for (int c = 0; c < cols; ++c) {
             const TerminalCell& cell = model.cell(c, r);
             uint32_t unicode = cell.ch;
             
-            // CURSOR HANDLING:
-            // If this is the cursor cell AND cursor is visible (blink state):
-            // We override look to BLOCK (0x2588) and COLOR.
-            // We must invalidate cache for cursor moving (gridIdx check logic).
-            // BUT signature is part of detection.
-            // We'll mix "isCursor" into signature.
-            
-            bool isCursor = (c == cursorX && r == cursorY && cursorVisible);
-            
-            // SELECTION DETECTION: Check if cell is within selection range
-            bool isSelected = false;
-            if (selStartCol >= 0 && selStartRow >= 0 && selEndCol >= 0 && selEndRow >= 0) {
-                // Normalize selection (handle backwards drag)
-                int sR1 = selStartRow, sC1 = selStartCol;
-                int sR2 = selEndRow, sC2 = selEndCol;
-                if (sR2 < sR1 || (sR2 == sR1 && sC2 < sC1)) {
-                    std::swap(sR1, sR2);
-                    std::swap(sC1, sC2);
-                }
-                
-                // Check if (c, r) is within selection
-                if (r > sR1 && r < sR2) {
-                    isSelected = true;  // Full row in middle
-                } else if (r == sR1 && r == sR2) {
-                    isSelected = (c >= sC1 && c <= sC2);  // Single row selection
-                } else if (r == sR1) {
-                    isSelected = (c >= sC1);  // First row
-                } else if (r == sR2) {
-                    isSelected = (c <= sC2);  // Last row
-                }
-            }
-            
+            // Selection and link hover are render-time overlays (particle.vert), not part of the signature
             uint32_t signature = unicode ^ (cell.attr.fgColor << 8) ^ (cell.attr.bgColor << 16) ^ (cell.attr.bold ? 0x80000000 : 0);
-            if (isCursor) signature ^= 0xFFFFFFFF; // Flip bits for cursor state
-            if (isSelected) signature ^= 0x55555555; // Different flip for selection
+            if (cell.attr.fgTrueColor) signature ^= 0x9E3779B9u * (1u + (cell.attr.fgR | (cell.attr.fgG << 8) | (cell.attr.fgB << 16)));
+            if (cell.attr.bgTrueColor) signature ^= 0x85EBCA6Bu * (1u + (cell.attr.bgR | (cell.attr.bgG << 8) | (cell.attr.bgB << 16)));
             
-            int gridIdx = r * cols + c;
+            int physRow = (r + m_rowHead) % rows;
+            int gridIdx = physRow * cols + c;
             
             if (!fullRebuild && m_prevGrid[gridIdx] == signature) {
                 continue; 
             }
             m_prevGrid[gridIdx] = signature;
-            
-            size_t baseIdx = (size_t)gridIdx * particlesPerCell;
-            if (baseIdx >= (size_t)m_maxParticles) continue; 
-            
-            if (baseIdx < minChangeIdx) minChangeIdx = baseIdx;
+            damageCell(c, r);
             
             int fgIdx = cell.attr.fgColor;
             int bgIdx = cell.attr.bgColor;
@@ -395,44 +926,13 @@ void ParticleSystem::updateParticlesFromTerminal(const TerminalModel& model, int
             
             bool inverse = cell.attr.inverse;
             
-            // CURSOR OVERRIDE
-            if (isCursor) {
-                // Force Block
-                unicode = 0x2588; 
-                // Force Amber Color (or Inverse of underlying?)
-                // User asked for "Solid Flashing Cursor".
-                // Let's make it Solid Amber (bright).
-                // Or if we want text VISIBLE under cursor, we inverse.
-                // Standard terminal: Inverse. 
-                // But "Solid" implies filled block.
-                // If I set unicode=Block, I lose text. 
-                // Unless I implement "Inverse" logic where block IS text.
-                // My font renderer draws PIXELS.
-                // If I draw Block, it draws 8x8 pixels. Text is lost.
-                // A true block cursor obscures text unless using XOR (not available) or Inverse.
-                // I'll stick to Block because user said "Solid".
-                // Maybe they mean "Not hollow"?
-                // Let's use Inverse logic if they want text visible.
-                // But "Solid Flashing Block" suggests Block.
-                // I will use Block. If they complain text is hidden, I'll switch to Inverse.
-                // Actually, standard is inverse.
-                // I'll try INVERSE first? 
-                // "Solid flashing cursor... where the cursor is".
-                // If I just invert, it's a solid block WITH text cut out.
-                // If I set unicode=2588, it's a solid block NO text.
-                // I'll use 2588 + Bright Amber.
-                fgIdx = 7; // White/Amber
-                fgTC = false;
-            } else {
-                 if (inverse) {
-                    std::swap(fgIdx, bgIdx); std::swap(fgTC, bgTC);
-                    std::swap(fgR, bgR); std::swap(fgG, bgG); std::swap(fgB, bgB);
-                }
-
+            if (inverse) {
+                std::swap(fgIdx, bgIdx); std::swap(fgTC, bgTC);
+                std::swap(fgR, bgR); std::swap(fgG, bgG); std::swap(fgB, bgB);
             }
 
             // TRACKING: Check if character changed (for animation trigger)
-            // 'unicode' holds the final rendered char (including cursor block 0x2588)
+            // (the cursor block is a separate layer, see CursorLayer)
             uint32_t prevChar = m_prevChars[gridIdx];
             bool charChanged = (prevChar != unicode);
             m_prevChars[gridIdx] = unicode;
@@ -440,355 +940,268 @@ void ParticleSystem::updateParticlesFromTerminal(const TerminalModel& model, int
             uint8_t fontCharIndex = mapUnicodeToCP437(unicode);
             if (unicode == 0) fontCharIndex = 32;
 
-            bool isBlockChar = (fontCharIndex == 0x2588 || fontCharIndex == 219);
+            // BACKGROUND LAYER: merged per-row quads, particles are reserved for glyph pixels
+            bool hasBackground = (bgIdx != 0 || bgTC);
+            uint32_t bgRef = bgTC ? trueColorRef(bgR, bgG, bgB) : paletteRef(bgIdx);
+            m_background.setCell(gridIdx, hasBackground ? bgRef : BackgroundLayer::NO_BACKGROUND);
 
-            // GHOST FIX: If it's a SPACE (32) and NO background color/inverse, 
-            // we MUST hide particles immediately.
-            // Otherwise, vector renderer might skip "empty" segments and leave old particles.
-            bool isVisualSpace = (fontCharIndex == 32 || fontCharIndex == 0) && (bgIdx == 0 && !bgTC && !inverse);
+            // GHOST FIX: If it's a SPACE (32) we MUST hide particles immediately
+            // (its background, if any, is drawn by the background layer)
+            bool isVisualSpace = (fontCharIndex == 32 || fontCharIndex == 0);
             if (isVisualSpace) {
-                 for (int i=0; i<particlesPerCell; ++i) {
-                     size_t idx = baseIdx + i;
-                     if (idx < (size_t)m_maxParticles) {
-                         m_posData[idx*4+3] = 0.0f; // Hide
-                         m_targetData[idx*4+0] = -10000.0f; 
-                         m_velData[idx*4+0] = 0.0f;
-                     }
-                 }
+                 releaseCellBlock(m_cellBlocks[gridIdx]); // Hides + frees its particles
+                 setCellRange(gridIdx, m_cellBlocks[gridIdx]);
                  continue; // Skip rendering
             }
 
-            float startX = c * charWidth;
-            float startY = r * charHeight;
-            
-            // FONT RENDER LOGIC
-            int pIdx = 0;
-            
-            // Debug first char of first row
-            if (c == 0 && r == 0) {
-                qDebug() << "FONT RENDER: Type=" << (m_font ? (int)m_font->type() : -1) 
-                         << "FontID=" << m_fontId
-                         << "Size=" << (m_font ? m_font->width() : 0) << "x" << (m_font ? m_font->height() : 0)
-                         << "CharIdx=" << fontCharIndex;
+            // GLYPH TEMPLATE: Bitmap fonts consume CP437, vector fonts consume unicode
+            bool isBitmap = (m_font->type() == FontType::Bitmap);
+            uint32_t glyphCode = isBitmap ? (uint32_t)fontCharIndex : unicode;
+            const GlyphTemplate& glyph = glyphCache.get(glyphCode, m_density, charWidth, charHeight);
+
+            int count = glyph.fgCount;
+
+            // ALLOCATE: power-of-two block per cell (ParticleAllocator), kept while the glyph needs its class
+            ParticleAllocator::Block& block = m_cellBlocks[gridIdx];
+            if (count == 0 || !ParticleAllocator::fits(block, count)) {
+                releaseCellBlock(block);
+                if (count > 0) allocateCellBlock(count, block);
+                setCellRange(gridIdx, block);
             }
-            
-            // Ensure gen is available (it is defined at line 287)
-            // auto* gen = QRandomGenerator::global(); 
-            
-            if (m_font->type() == FontType::Bitmap) {
-                // ... (Bitmap logic skipped) ...
-                int fw = m_font->width();
-                int fh = m_font->height();
-                float pixelW = charWidth / (float)fw;
-                float pixelH = charHeight / (float)fh;
-                
-                for (int cy = 0; cy < fh; ++cy) {
-                    for (int cx = 0; cx < fw; ++cx) {
-                        bool isTextPixel = m_font->getPixel(fontCharIndex, cx, cy);
-                        
-                        // --- REUSED COLOR LOGIC ---
-                        int colorToUse = -1; 
-                        bool useTrueColor = false;
-                        float tcR=0, tcG=0, tcB=0;
-                        
-                        // Extract color calc to helper or duplicate for now
-                        if (isTextPixel) {
-                            if (fgTC) { useTrueColor = true; tcR=fgR/255.0f; tcG=fgG/255.0f; tcB=fgB/255.0f; colorToUse=999; }
-                            else { colorToUse = fgIdx; }
-                        } else {
-                            if (bgTC) { useTrueColor = true; tcR=bgR/255.0f; tcG=bgG/255.0f; tcB=bgB/255.0f; colorToUse=999; }
-                            else if (bgIdx != 0) { colorToUse = bgIdx; }
-                        }
-
-                        // Optimization: For solid background blocks, use fewer but larger particles
-                        int activeDensity = m_density;
-                        float sizeScale = 1.0f;
-                        if (!isTextPixel && colorToUse != -1) {
-                             activeDensity = std::max(1, m_density / 4);
-                             sizeScale = 2.0f; 
-                        }
-                        
-                        for (int i = 0; i < m_density; ++i) {
-                             size_t currentIdx = baseIdx + pIdx;
-                             pIdx++;
-                             if (currentIdx >= (size_t)m_maxParticles) break;
-                             if (currentIdx > maxChangeIdx) maxChangeIdx = currentIdx;
-
-                             if (i >= activeDensity) { // Hide optimization
-                                 m_posData[currentIdx*4 + 3] = 0.0f; m_targetData[currentIdx*4+0] = -10000.0f; continue;
-                             }
-
-                             float jx = m_jitterTable[(m_jitterIndex++) % 8192] * pixelW * 0.1f * 0.5f;
-                             float jy = m_jitterTable[(m_jitterIndex++) % 8192] * pixelH * 0.1f * 0.5f;
-                             float tx = startX + cx * pixelW + (pixelW * 0.5f) + jx;
-                             float ty = startY + cy * pixelH + (pixelH * 0.5f) + jy;
-                             
-                             float size = 0.0f; 
-                             if (colorToUse != -1) size = std::max(1.5f, pixelW * 0.65f) * sizeScale;
-
-                             m_targetData[currentIdx*4 + 0] = tx;
-                             m_targetData[currentIdx*4 + 1] = ty;
-                             m_targetData[currentIdx*4 + 2] = 0.0f;
-                             m_targetData[currentIdx*4 + 3] = size;
-
-                             float rVal=0, gVal=0, bVal=0;
-                             if (colorToUse != -1) {
-                                 if (useTrueColor) { rVal=tcR; gVal=tcG; bVal=tcB; }
-                                 else {
-                                     // Default Palette Logic
-                                     if (colorToUse==0 && isTextPixel) { 
-                                         if (m_theme == THEME_CYBERPUNK) { rVal=1.0f; gVal=1.0f; bVal=1.0f; } 
-                                         else { rVal=0.15f; gVal=0.15f; bVal=0.15f; }
-                                     }
-                                     else if (colorToUse == 1) { rVal=1.0f; gVal=0.2f; bVal=0.2f; }
-                                     else if (colorToUse == 2) { rVal=0.2f; gVal=1.0f; bVal=0.2f; }
-                                     else if (colorToUse == 4) { rVal=0.2f; gVal=0.4f; bVal=1.0f; }
-                                     else { rVal=1.0f; gVal=0.59f; bVal=0.04f; } 
-                                 }
-                             }
-                             
-                             bool isUnderCursor = (c == cursorX && r == cursorY && cursorVisible);
-                             bool shouldInvert = isSelected || isUnderCursor;
-                             if (shouldInvert) { rVal=1.0f-rVal; gVal=1.0f-gVal; bVal=1.0f-bVal; }
-                             
-                             bool isLink = (r == linkRow && c >= linkStart && c <= linkEnd);
-                             if (isLink && isTextPixel) { gVal=1.0f; bVal=1.0f; rVal=0.0f; } 
-
-                             m_colorData[currentIdx*4 + 0] = rVal;
-                             m_colorData[currentIdx*4 + 1] = gVal;
-                             m_colorData[currentIdx*4 + 2] = bVal;
-                             m_colorData[currentIdx*4 + 3] = 1.0f; // Alpha
-                             
-                             // CRITICAL FIX: Set m_posData (size AND position) for visibility
-                             m_posData[currentIdx*4 + 0] = tx;
-                             m_posData[currentIdx*4 + 1] = ty;
-                             m_posData[currentIdx*4 + 2] = 0.0f;
-                             m_posData[currentIdx*4 + 3] = size;
-                             
-                             // Extra Data (Pulse seed)
-                             // Block Chars use Bitmap path but should NOT shimmer (use 0.0f)
-                             // Only actual Bitmap Text (Classic Font) should shimmer (1.0f)
-                             m_extraData[currentIdx*4 + 0] = (isTextPixel && !isBlockChar) ? 1.0f : 0.0f;
-                             
-                             // HANDLE STARTUP ANIMATION (Simple Jitter for Update)
-                             if (charChanged && size > 0.0f) {
-                                  if (m_animationStyle == 2) {
-                                      m_posData[currentIdx*4 + 1] -= (200.0f + gen->generateDouble() * 200.0f);
-                                  } else {
-                                      float ang = gen->generateDouble() * 6.28f;
-                                      float dst = 100.0f;
-                                      m_posData[currentIdx*4 + 0] += cos(ang)*dst;
-                                      m_posData[currentIdx*4 + 1] += sin(ang)*dst;
-                                  }
-                             }
-                        }
-                    }
-                }
+            if (!block.valid()) continue;
+            size_t baseIdx = block.first;
+            int capacity = (int)block.capacity();
+
+            // COLOR REFS (resolved through the palette UBO at render time)
+            uint32_t fgRef = fgTC ? trueColorRef(fgR, fgG, fgB) : paletteRef(fgIdx);
+
+            if (gpuExpand) {
+                uint32_t attr = (charChanged ? CELL_CHANGED : 0) | (isBitmap ? 0 : CELL_VECTOR);
+                queueCell(gridIdx, (uint32_t)glyph.slot, attr, fgRef, block);
+                continue;
+            }
+
+            float startX = c * charWidth;
+            float startY = physRow * charHeight;
+
+            // INSTANTIATE: copy template + translate into cell (scratch for the dirty set only)
+            const float* offs = glyph.offsets.data();
+            size_t scratchIdx = reserveScratch(capacity);
+            int i = 0;
+            for (; i < count; ++i) {
+                 size_t currentIdx = scratchIdx + i;
+
+                 uint8_t flags = glyph.flags[i];
+                 float tx = startX + offs[i*4 + 0];
+                 float ty = startY + offs[i*4 + 1];
+                 float size = offs[i*4 + 3];
+
+
+                 // Extra Data (Pulse seed)
+                 // SMART STABILITY: Vector text only animates if char changed. Static text = 0.0 shimmer.
+                 bool shimmer = (flags & GLYPH_SHIMMER) && (isBitmap || charChanged);
+
+                 // HANDLE STARTUP ANIMATION (Fly-In) - offset from target
+                 float dx = 0.0f, dy = 0.0f, dz = 0.0f;
+                 if (charChanged) {
+                      if (!isBitmap) {
+                          dz = 50.0f;
+                      } else if (m_animationStyle == 2) {
+                          dy = -(200.0f + gen->generateDouble() * 200.0f);
+                      } else {
+                          float ang = gen->generateDouble() * 6.28f;
+                          float dst = 100.0f;
+                          dx = cos(ang)*dst;
+                          dy = sin(ang)*dst;
+                      }
+                 }
+
+                 writeParticle(currentIdx, tx, ty, size, dx, dy, dz, fgRef, shimmer ? 1.0f : 0.0f,
+                               true);
             }
 
-            else if (m_font->type() == FontType::Vector) {
-                    std::vector<VectorSegment> segments;
-                    if (m_font) segments = m_font->getSegments(unicode);
-                    
-                    // SPACE HANDLING: If Space (32) has a background color (or is inverse),
-                    // treat it as a BLOCK CHAR (0x2588) so visual scanning fills it.
-                    if (fontCharIndex == 32 && (bgIdx != 0 || bgTC || inverse)) {
-                        fontCharIndex = 0x2588; 
-                        // If it was just inverse space, we need to ensure the "Block" logic sees it as "Fill".
-                        // Logic below checks for 0x2588.
-                    }
-
-                    // ZERO-TOLERANCE CLEANUP:
-                    // If the character changed, we MUST clear all particles for this cell first.
-                    // This prevents "Ghost Particles" from previous letters persisting if the new letter has fewer scan points.
-                    // The "Cleanup Loop" at the end catches *unused* ones, but this is a safety nuke.
-                    if (charChanged) {
-                         for (int i=0; i<particlesPerCell; ++i) {
-                             size_t idx = baseIdx + i;
-                             if (idx < (size_t)m_maxParticles) {
-                                 m_posData[idx*4+3] = 0.0f; // Hide
-                                 m_targetData[idx*4+0] = -10000.0f; // Banished
-                                 m_velData[idx*4+0] = 0.0f; // Stop
-                                 m_extraData[idx*4+0] = 0.0f; // Reset Phase
-                                 m_extraData[idx*4+1] = 0.0f;
-                                 m_extraData[idx*4+2] = 0.0f;
-                                 m_extraData[idx*4+3] = 0.0f;
-                             }
-                         }
-                    }
-
-                    // UNIFIED RASTER-SCAN APPROACH (On-the-fly Rasterization)
-                    // 1. Scan virtual grid (12x18)
-                    // 2. Check Point-to-Segment (FG)
-                    // 3. Fallback to Background (BG)
-                    
-                    int gridW = 12; 
-                    int gridH = 18;
-                    
-                    for (int gy = 0; gy < gridH; ++gy) {
-                        for (int gx = 0; gx < gridW; ++gx) {
-                            float nx = (gx + 0.5f) / (float)gridW; 
-                            float ny = (gy + 0.5f) / (float)gridH; 
-                            
-                            bool isFg = false;
-                            
-                            // 1. Block Character Override
-                            if (fontCharIndex == 0x2588 || fontCharIndex == 219) {
-                                isFg = true;
-                            } 
-                            // 2. Vector Segment Check
-                            else if (!segments.empty()) {
-                                for (const auto& seg : segments) {
-                                    float l2 = pow(seg.x2 - seg.x1, 2) + pow(seg.y2 - seg.y1, 2);
-                                    if (l2 == 0) { 
-                                        float d = pow(nx - seg.x1, 2) + pow(ny - seg.y1, 2);
-                                        if (d < 0.005f) { isFg = true; break; }
-                                    } else {
-                                        float t = ((nx - seg.x1) * (seg.x2 - seg.x1) + (ny - seg.y1) * (seg.y2 - seg.y1)) / l2;
-                                        t = std::max(0.0f, std::min(1.0f, t));
-                                        float px = seg.x1 + t * (seg.x2 - seg.x1);
-                                        float py = seg.y1 + t * (seg.y2 - seg.y1);
-                                        float dist = pow(nx - px, 2) + pow(ny - py, 2);
-                                        if (dist < 0.008f) { isFg = true; break; } 
-                                    }
-                                }
-                            }
-                            
-                            // 3. COLOR SELECTION
-                            // If isFg -> Use Text Color
-                            // Else If hasBackground -> Use Background Color (Fill)
-                            // Else -> Skip
-                            
-                            int colorToUse = -1;
-                            bool useTrueColor = false;
-                            float tcR=0, tcG=0, tcB=0;
-                            
-                            bool hasBackground = (bgIdx != 0) || bgTC || (inverse && !isFg); 
-                             
-                            if (isFg) {
-                                if (fgTC) { useTrueColor = true; tcR=fgR/255.0f; tcG=fgG/255.0f; tcB=fgB/255.0f; colorToUse=999; }
-                                else { colorToUse = fgIdx; }
-                            } else if ((bgIdx != 0 || bgTC) && fontCharIndex != 0x2588) { 
-                                 if (bgTC) { useTrueColor = true; tcR=bgR/255.0f; tcG=bgG/255.0f; tcB=bgB/255.0f; colorToUse=999; }
-                                 else { colorToUse = bgIdx; }
-                            }
-                            
-                            if (colorToUse == -1) continue; // Scanline empty
-
-                            // Spawn Particles
-                            int activeDensity = m_density;
-                             // Optimize solid backgrounds (non-text pixels)
-                            if (!isFg) activeDensity = std::max(1, m_density / 2);
-
-                            for (int i = 0; i < m_density; ++i) {
-                                 size_t currentIdx = baseIdx + pIdx;
-                                 pIdx++;
-                                 if (currentIdx >= (size_t)m_maxParticles) break;
-                                 if (currentIdx > maxChangeIdx) maxChangeIdx = currentIdx;
-                                 
-                                 if (i >= activeDensity) {
-                                     m_posData[currentIdx*4 + 3] = 0.0f; 
-                                     m_targetData[currentIdx*4+0] = -10000.0f; 
-                                     continue;
-                                 }
-
-                                 float jx = m_jitterTable[(m_jitterIndex++) % 8192] * 0.005f;
-                                 float jy = m_jitterTable[(m_jitterIndex++) % 8192] * 0.015f;
-                                 
-                                 float tx = startX + nx * charWidth + jx;
-                                 float ty = startY + ny * charHeight + jy;
-                                 
-                                 float size = std::max(1.5f, charWidth/12.0f * 0.9f);
-                                 
-                                 m_targetData[currentIdx*4 + 0] = tx;
-                                 m_targetData[currentIdx*4 + 1] = ty;
-                                 m_targetData[currentIdx*4 + 2] = 0.0f;
-                                 m_targetData[currentIdx*4 + 3] = size;
-
-                                 float rVal=0, gVal=0, bVal=0;
-                                 if (useTrueColor) { rVal=tcR; gVal=tcG; bVal=tcB; }
-                                 else {
-                                     // Palette lookup
-                                     if (colorToUse == 7) { rVal=1.0f; gVal=0.7f; bVal=0.0f; } // Amber/White
-                                     else if (colorToUse == 0) { rVal=0.1f; gVal=0.1f; bVal=0.1f; } // Black
-                                     else if (colorToUse == 1) { rVal=1.0f; gVal=0.2f; bVal=0.2f; } // Red
-                                     else if (colorToUse == 2) { rVal=0.2f; gVal=1.0f; bVal=0.2f; } // Green
-                                     else if (colorToUse == 4) { rVal=0.2f; gVal=0.4f; bVal=1.0f; } // Blue
-                                     else { rVal=0.8f; gVal=0.8f; bVal=0.8f; } // Default
-                                 }
-                                 
-                                 m_colorData[currentIdx*4 + 0] = rVal;
-                                 m_colorData[currentIdx*4 + 1] = gVal;
-                                 m_colorData[currentIdx*4 + 2] = bVal;
-                                 m_colorData[currentIdx*4 + 3] = 1.0f;
-
-                                 // Immediate update for visibility
-                                 m_posData[currentIdx*4 + 0] = tx;
-                                 m_posData[currentIdx*4 + 1] = ty;
-                                 m_posData[currentIdx*4 + 2] = 0.0f;
-                                 m_posData[currentIdx*4 + 3] = size;
-                                 
-                                 // SMART STABILITY: 
-                                 // Only animate if char changed. Static text = 0.0 shimmer.
-                                 m_extraData[currentIdx*4 + 0] = (isFg && charChanged) ? 1.0f : 0.0f; 
-                                 
-                                 if (charChanged && size > 0.0f) {
-                                      m_posData[currentIdx*4 + 2] += 50.0f;
-                                 }
-                            }
-                    }}
-                    
-                    // CLEANUP: Hide unused particles (CRITICAL STEP - Was missing!)
-                    while (pIdx < particlesPerCell) {
-                         size_t currentIdx = baseIdx + pIdx;
-                         pIdx++;
-                         if (currentIdx >= (size_t)m_maxParticles) break;
-                         m_posData[currentIdx*4 + 3] = 0.0f; 
-                         m_targetData[currentIdx*4 + 0] = -10000.0f;
-                         m_velData[currentIdx*4 + 0] = 0.0f; // Reset vel
-                    }
+            // CLEANUP: Hide unused particles of this cell's block
+            for (; i < capacity; ++i) {
+                 hideParticle(scratchIdx + i);
             }
 
-            // Garbage lines removed
+            // DIRTY SPANS: the rewritten block on all streams, sourced from scratch
+            m_uploader.markDirty(PARTICLE_STREAMS, baseIdx, capacity, scratchIdx);
+            m_dirtyCells.push_back((uint32_t)gridIdx);
 
 
         }
     }
 
-    if (minChangeIdx <= maxChangeIdx) {
-        size_t startByte = minChangeIdx * 4 * sizeof(float);
-        size_t count = (maxChangeIdx - minChangeIdx + 1);
-        size_t sizeBytes = count * 4 * sizeof(float);
+    // SIZE TO NEED: grow past the high-water mark before anything writes the new blocks
+    fitParticleBuffers(fullRebuild, preserved);
+
+    m_visibleDirty = true; // Liveness may have changed
+    
+    // DEFRAG: most of the pool sits in free lists -> repack on the next update
+    uint32_t highWater = m_allocator.highWater();
+    if (highWater > 65536 && highWater > m_allocator.liveParticles() * 2) {
+        m_defragPending = true;
+        m_prevGrid.clear();
+    }
+    
+    // DIRTY LIST: drives GPU expansion and wakes the regenerated cells' physics
+    if (!m_dirtyCells.empty()) {
+        ensureBufferCapacity(m_dirtyCellSsbo, m_dirtyCellCapacity, (int)m_dirtyCells.size(), sizeof(uint32_t));
+        m_uploader.markDirty(1u << STREAM_DIRTY_CELLS, 0, m_dirtyCells.size());
+    }
+    
+    if (gpuExpand) {
+        dispatchExpansion(cols, charWidth, charHeight);
+    } else {
+        flushUploads();
+    }
+    wakeDirtyCells();
+    
+    // Idle detection must see a motion count taken after this regeneration
+    m_wakeFrame = m_physicsFrame + 1;
+}
+
+void ParticleSystem::wakeAllCells()
+{
+    if (!m_cellMotionSsbo) return;
+    const GLuint awake = 1;
+    glClearNamedBufferData(m_cellMotionSsbo, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &awake);
+}
+
+void ParticleSystem::wakeDirtyCells()
+{
+    if (!m_cellsProgram || m_dirtyCells.empty() || !m_cellMotionSsbo) return;
+    
+    int dirtyCount = (int)m_dirtyCells.size();
+    m_cellsProgram->bind();
+    m_cellsProgram->setUniformValue("uMode", 0);
+    m_cellsProgram->setUniformValue("uCount", dirtyCount);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, m_dirtyCellSsbo);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 13, m_cellMotionSsbo);
+    glDispatchCompute((dirtyCount + 255) / 256, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+void ParticleSystem::buildActiveCells()
+{
+    const GLuint emptyDispatch[4] = { 0, 1, 1, 0 };
+    glNamedBufferSubData(m_activeIndirectBuffer, 0, sizeof(emptyDispatch), emptyDispatch);
+    
+    int cellCount = m_gridCols * m_gridRows;
+    if (cellCount <= 0 || !m_cellMotionSsbo) return;
+    
+    m_cellsProgram->bind();
+    m_cellsProgram->setUniformValue("uMode", 1);
+    m_cellsProgram->setUniformValue("uCount", cellCount);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 11, m_activeCellSsbo);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 13, m_cellMotionSsbo);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 14, m_activeIndirectBuffer);
+    glDispatchCompute((cellCount + 255) / 256, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+}
+
+void ParticleSystem::pollMotionReadback()
+{
+    // Non-blocking: only slots whose copy already completed are read
+    for (int i = 0; i < MOTION_READBACK_SLOTS; ++i) {
+        GLsync& fence = m_motionFences[i];
+        if (!fence) continue;
+        GLenum result = glClientWaitSync(fence, 0, 0);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) continue;
         
-        size_t totalBytes = m_posData.size() * sizeof(float);
-        if (startByte + sizeBytes > totalBytes) {
-            sizeBytes = totalBytes - startByte;
+        if (m_motionSlotFrame[i] > m_motionFrame) {
+            glGetNamedBufferSubData(m_motionReadback, i * sizeof(GLuint), sizeof(GLuint), &m_movingParticles);
+            m_motionFrame = m_motionSlotFrame[i];
         }
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+}
 
-        if (sizeBytes > 0) {
-            glBindBuffer(GL_ARRAY_BUFFER, m_posVbo);
-            glBufferSubData(GL_ARRAY_BUFFER, startByte, sizeBytes, &m_posData[minChangeIdx*4]);
-            
-            glBindBuffer(GL_ARRAY_BUFFER, m_velVbo);
-            glBufferSubData(GL_ARRAY_BUFFER, startByte, sizeBytes, &m_velData[minChangeIdx*4]);
-            
-            glBindBuffer(GL_ARRAY_BUFFER, m_targetVbo);
-            glBufferSubData(GL_ARRAY_BUFFER, startByte, sizeBytes, &m_targetData[minChangeIdx*4]);
-            
-            glBindBuffer(GL_ARRAY_BUFFER, m_colorVbo);
-            glBufferSubData(GL_ARRAY_BUFFER, startByte, sizeBytes, &m_colorData[minChangeIdx*4]);
-        }
+void ParticleSystem::queueMotionReadback()
+{
+    // GPU more than MOTION_READBACK_SLOTS frames behind: skip this sample
+    if (m_motionFences[m_motionSlot]) return;
+    
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glCopyNamedBufferSubData(m_motionCounter, m_motionReadback, 0, m_motionSlot * sizeof(GLuint), sizeof(GLuint));
+    m_motionFences[m_motionSlot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_motionSlotFrame[m_motionSlot] = m_physicsFrame;
+    m_motionSlot = (m_motionSlot + 1) % MOTION_READBACK_SLOTS;
+}
+
+bool ParticleSystem::isSettled() const
+{
+    // Quantum jitter and a live shockwave keep moving without the counter noticing
+    bool shockwaveActive = (m_animationStyle == STYLE_SONIC && m_shockTime > 0.0f &&
+                            m_elapsedTime - m_shockTime < 1.0f);
+    if (m_animationStyle == STYLE_QUANTUM || shockwaveActive) return false;
+    return m_motionFrame >= m_wakeFrame && m_movingParticles == 0;
+}
+
+void ParticleSystem::flushUploads()
+{
+    UploadEngine::Source sources[STREAM_COUNT];
+    if (m_layoutCompact) {
+        const size_t word = sizeof(uint32_t);
+        sources[STREAM_MOTION] = { m_motionVbo, m_scratchPackedMotion.data(), 2 * word };
+        sources[STREAM_SHAPE] = { m_shapeVbo, m_scratchPackedShape.data(), word };
+        sources[STREAM_TARGET] = { m_targetVbo, m_scratchPackedTarget.data(), word };
+        sources[STREAM_EXTRA] = { m_extraVbo, m_scratchPackedExtra.data(), word };
+        sources[STREAM_COLOR] = { m_colorVbo, m_scratchPackedColor.data(), word };
+    } else {
+        const size_t vec4Bytes = 4 * sizeof(float);
+        const size_t vec2Bytes = 2 * sizeof(float);
+        sources[STREAM_MOTION] = { m_motionVbo, m_scratchMotion.data(), vec4Bytes };
+        sources[STREAM_SHAPE] = { m_shapeVbo, m_scratchShape.data(), vec2Bytes };
+        sources[STREAM_TARGET] = { m_targetVbo, m_scratchTarget.data(), vec2Bytes };
+        sources[STREAM_EXTRA] = { m_extraVbo, m_scratchExtra.data(), vec4Bytes };
+        sources[STREAM_COLOR] = { m_colorVbo, m_scratchColor.data(), vec4Bytes };
     }
+    sources[STREAM_STATE] = { m_stateVbo, m_scratchState.data(), sizeof(uint8_t) };
+    sources[STREAM_CELLS] = { m_cellSsbo, m_cellData.data(), 4 * sizeof(uint32_t) };
+    sources[STREAM_DIRTY_CELLS] = { m_dirtyCellSsbo, m_dirtyCells.data(), sizeof(uint32_t) };
+    sources[STREAM_CELL_RANGES] = { m_cellRangeSsbo, m_cellRanges.data(), sizeof(uint32_t) };
+    m_uploader.flush(sources, STREAM_COUNT);
+    releaseScratch(); // Copied into the staging ring
+}
+
+void ParticleSystem::compactVisible()
+{
+    m_visibleDirty = false;
+    
+    // Reset all commands, then count live particles into them
+    const GLuint emptyCommands[12] = { 4, 0, 0, 0, 0, 1, 1, 0, 0, 1, 0, 0 };
+    glNamedBufferSubData(m_indirectBuffer, 0, sizeof(emptyCommands), emptyCommands);
+    if (m_particleCount <= 0) return;
+    
+    ensureBufferCapacity(m_visibleSsbo, m_visibleCapacity, m_particleCount, sizeof(GLuint));
+    
+    m_compactProgram->bind();
+    m_compactProgram->setUniformValue("uParticleCount", m_particleCount);
+    
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ParticleBuffers::STATE_BINDING, m_stateVbo);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 9, m_visibleSsbo);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 10, m_indirectBuffer);
+    
+    glDispatchCompute((m_particleCount + 255) / 256, 1, 1);
+    
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
 }
 
-void ParticleSystem::resize(int width, int height)
+void ParticleSystem::resize(int width, int height, float pixelRatio)
 {
     m_width = width;
     m_height = height;
+    m_pixelRatio = pixelRatio;
 }
 
 void ParticleSystem::update(float dt)
 {
+    applyParticleLayout();
+    selectShaderVariants();
+    if (m_useVisibleList && m_visibleDirty) compactVisible();
     if (!m_computeProgram) {
         static bool warned = false;
         if (!warned) { qDebug() << "ERROR: No compute program!"; warned = true; }
@@ -796,6 +1209,13 @@ void ParticleSystem::update(float dt)
     }
     
     m_elapsedTime += dt;
+    m_physicsFrame++;
+    pollMotionReadback();
+    
+    // SUSTAINED UNDERUSE: give the memory back to the shared budget, keeping the live prefix
+    if (m_buffers.shouldShrink(m_particleCount, m_elapsedTime)) {
+        resizeParticleBuffers(ParticleBuffers::fittedCapacity(m_particleCount), m_particleCount);
+    }
     
     // Debug: print every second
     static float debugTimer = 0;
@@ -805,28 +1225,53 @@ void ParticleSystem::update(float dt)
         debugTimer = 0;
     }
 
-    m_computeProgram->bind();
-    m_computeProgram->setUniformValue("deltaTime", dt);
-    m_computeProgram->setUniformValue("elapsedTime", m_elapsedTime);
-    m_computeProgram->setUniformValue("bounds", QVector2D(m_width, m_height));
+    // ACTIVE CELLS: settled glyphs are skipped. Quantum jitter and a live
+    // shockwave move particles regardless of cell state -> full pass.
+    bool shockwaveActive = (m_animationStyle == STYLE_SONIC && m_shockTime > 0.0f &&
+                            m_elapsedTime - m_shockTime < 1.0f);
+    bool fullPhysics = !m_cellPhysicsProgram || m_animationStyle == STYLE_QUANTUM || shockwaveActive;
+    if (!fullPhysics) {
+        if (m_fullPhysics) wakeAllCells(); // Full pass may have displaced any particle
+        buildActiveCells();
+    }
+    m_fullPhysics = fullPhysics;
     
-    // Pass adjustable physics params
-    m_computeProgram->setUniformValue("uSpringK", m_springK);
-    m_computeProgram->setUniformValue("uDrag", m_drag);
-    m_computeProgram->setUniformValue("uShimmerBase", m_shimmerSpeed);
-    m_computeProgram->setUniformValue("uStyle", m_animationStyle);
-    m_computeProgram->setUniformValue("uShockwave", QVector3D(m_shockX, m_shockY, m_shockTime));
+    QOpenGLShaderProgram* physics = fullPhysics ? m_computeProgram : m_cellPhysicsProgram;
+    physics->bind();
+    writeFrameUniforms(dt); // Physics params, clock and shockwave (style is a compile-time variant)
     
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_posVbo);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_velVbo);
+    // Hot streams only: shape, extra and color are never read by physics
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_motionVbo);
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_targetVbo);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_extraVbo);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, m_colorVbo);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ParticleBuffers::STATE_BINDING, m_stateVbo);
+    
+    const GLuint zero = 0;
+    glClearNamedBufferData(m_motionCounter, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, &zero);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 15, m_motionCounter);
     
-    int groups = (m_particleCount + 255) / 256;
-    glDispatchCompute(groups, 1, 1);
+    if (!fullPhysics) {
+        // One workgroup per animating cell
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 11, m_activeCellSsbo);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 12, m_cellRangeSsbo);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 13, m_cellMotionSsbo);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 14, m_activeIndirectBuffer);
+        glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, m_activeIndirectBuffer);
+        glDispatchComputeIndirect(0);
+        glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+    } else if (m_useVisibleList) {
+        // Only live particles: group count was written by the compaction pass
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 9, m_visibleSsbo);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 10, m_indirectBuffer);
+        glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, m_indirectBuffer);
+        glDispatchComputeIndirect(4 * sizeof(GLuint));
+        glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+    } else {
+        int groups = (m_particleCount + 255) / 256;
+        glDispatchCompute(groups, 1, 1);
+    }
     
-    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+    queueMotionReadback();
 }
 
 void ParticleSystem::setZoomLevel(float zoom)
@@ -851,6 +1296,103 @@ void ParticleSystem::adjustQuality(float currentFps, float targetFps)
     }
 }
 
+float ParticleSystem::ringY(float screenY) const
+{
+    if (m_rowHead == 0 || m_gridRows <= 0) return screenY;
+    int screenRow = std::max(0, std::min(m_gridRows - 1, (int)(screenY / m_gridCellHeight)));
+    int physRow = (screenRow + m_rowHead) % m_gridRows;
+    return screenY + (physRow - screenRow) * m_gridCellHeight;
+}
+
+void ParticleSystem::setCursor(int col, int row, bool visible)
+{
+    bool onScreen = col >= 0 && col < m_gridCols && row >= 0 && row < m_gridRows;
+    m_cursor.setCursor(QVector2D(col * m_gridCellWidth, row * m_gridCellHeight), visible && onScreen, m_elapsedTime);
+}
+
+void ParticleSystem::setSelection(int startCol, int startRow, int endCol, int endRow)
+{
+    if (startCol < 0 || startRow < 0 || endCol < 0 || endRow < 0) {
+        m_selection[0] = m_selection[1] = m_selection[2] = m_selection[3] = -1;
+        return;
+    }
+    // Normalize selection (handle backwards drag)
+    if (endRow < startRow || (endRow == startRow && endCol < startCol)) {
+        std::swap(startRow, endRow);
+        std::swap(startCol, endCol);
+    }
+    m_selection[0] = startCol;
+    m_selection[1] = startRow;
+    m_selection[2] = endCol;
+    m_selection[3] = endRow;
+}
+
+void ParticleSystem::setHoveredLink(int row, int startCol, int endCol)
+{
+    m_link[0] = row;
+    m_link[1] = startCol;
+    m_link[2] = endCol;
+}
+
+// xterm 256: 16 ANSI colors, 6x6x6 cube, 24 grays. Defaults keep the amber look.
+static QVector3D defaultPaletteColor(int index)
+{
+    static const uint8_t ansi[16][3] = {
+        {  26,  26,  26 }, { 255,  51,  51 }, {  51, 255,  51 }, { 205, 205,   0 },
+        {  51, 102, 255 }, { 205,   0, 205 }, {   0, 205, 205 }, { 255, 150,  10 }, // 7 = Amber
+        { 127, 127, 127 }, { 255,   0,   0 }, {   0, 255,   0 }, { 255, 255,   0 },
+        {  92,  92, 255 }, { 255,   0, 255 }, {   0, 255, 255 }, { 255, 255, 255 }
+    };
+    static const uint8_t cube[6] = { 0, 95, 135, 175, 215, 255 };
+    
+    uint8_t rgb[3];
+    if (index < 16) {
+        rgb[0] = ansi[index][0]; rgb[1] = ansi[index][1]; rgb[2] = ansi[index][2];
+    } else if (index < 232) {
+        int c = index - 16;
+        rgb[0] = cube[c / 36]; rgb[1] = cube[(c / 6) % 6]; rgb[2] = cube[c % 6];
+    } else {
+        rgb[0] = rgb[1] = rgb[2] = (uint8_t)(8 + (index - 232) * 10);
+    }
+    return QVector3D(rgb[0] / 255.0f, rgb[1] / 255.0f, rgb[2] / 255.0f);
+}
+
+void ParticleSystem::resetPalette()
+{
+    m_palette.assign(PALETTE_ENTRIES * 4, 1.0f);
+    for (int i = 0; i < PALETTE_COLORS; ++i) setPaletteColor(i, defaultPaletteColor(i));
+    applyPaletteTheme();
+}
+
+void ParticleSystem::resetPaletteColor(int index)
+{
+    if (index < 0 || index >= PALETTE_COLORS) return;
+    setPaletteColor(index, defaultPaletteColor(index));
+}
+
+void ParticleSystem::applyPaletteTheme()
+{
+    // Index 0 on text pixels (e.g. inverse video): white on Cyberpunk, dark gray elsewhere
+    float textBlack = (m_theme == THEME_CYBERPUNK) ? 1.0f : 0.15f;
+    for (int k = 0; k < 3; ++k) m_palette[PALETTE_TEXT_BLACK * 4 + k] = textBlack;
+    m_paletteDirty = true;
+}
+
+void ParticleSystem::setPaletteColor(int index, const QVector3D& color)
+{
+    if (index < 0 || index >= PALETTE_COLORS) return;
+    m_palette[index * 4 + 0] = color.x();
+    m_palette[index * 4 + 1] = color.y();
+    m_palette[index * 4 + 2] = color.z();
+    m_paletteDirty = true;
+}
+
+QVector3D ParticleSystem::paletteColor(int index) const
+{
+    if (index < 0 || index >= PALETTE_COLORS) return QVector3D();
+    return QVector3D(m_palette[index * 4 + 0], m_palette[index * 4 + 1], m_palette[index * 4 + 2]);
+}
+
 void ParticleSystem::triggerShockwave(float x, float y) {
     m_shockX = x;
     m_shockY = y;
@@ -859,6 +1401,7 @@ void ParticleSystem::triggerShockwave(float x, float y) {
 
 void ParticleSystem::setTheme(int theme) {
     m_theme = theme;
+    applyPaletteTheme();
     
     // Apply Presets
     if (theme == THEME_CYBERPUNK) {
@@ -877,29 +1420,145 @@ void ParticleSystem::setTheme(int theme) {
 
 void ParticleSystem::render(const QMatrix4x4& projection)
 {
+    selectShaderVariants();
     if (!m_renderProgram) return;
 
-    m_renderProgram->bind();
+    m_frameProjection = projection;
+    m_frameProjection.translate(m_width/2, m_height/2);
+    m_frameProjection.scale(m_zoomLevel);
+    m_frameProjection.translate(-m_width/2, -m_height/2);
     
-    QMatrix4x4 finalProj = projection;
-    finalProj.translate(m_width/2, m_height/2);
-    finalProj.scale(m_zoomLevel);
-    finalProj.translate(-m_width/2, -m_height/2);
+    // Frame UBO: every per-frame uniform of the render, background and cursor programs
+    FrameUniforms frame = {};
+    fillFrameUniforms(frame, 0.0f);
+    uploadFrameUniforms(frame);
     
-    m_renderProgram->setUniformValue("projection", finalProj);
-    m_renderProgram->setUniformValue("glowIntensity", m_glowIntensity);
-    m_renderProgram->setUniformValue("uBrightness", m_brightness);
-    m_renderProgram->setUniformValue("uVibrance", m_vibrance); // FIXED
-    m_renderProgram->setUniformValue("uShimmerSpeed", m_shimmerSpeed);
-    m_renderProgram->setUniformValue("elapsedTime", m_elapsedTime); 
+    // Palette: one small upload per change, no particle regeneration
+    if (m_paletteDirty) {
+        glNamedBufferSubData(m_paletteUbo, 0, m_palette.size() * sizeof(float), m_palette.data());
+        m_paletteDirty = false;
+        m_cacheValid = false;
+    }
+    glBindBufferBase(GL_UNIFORM_BUFFER, 0, m_paletteUbo);
     
-    // Theme Uniforms
-    m_renderProgram->setUniformValue("uScanlineIntensity", m_scanlineIntensity);
-    m_renderProgram->setUniformValue("uColorTint", m_colorTint); // vec3
-    m_renderProgram->setUniformValue("uTheme", m_theme);
-    m_renderProgram->setUniformValue("uResolution", QVector2D(m_width, m_height)); 
+    m_presentedFromCache = false;
+    if (m_cacheProgram) {
+        renderCached(frame);
+    } else {
+        drawScene(false);
+    }
     
-    glBindVertexArray(m_vao);
-    glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, m_particleCount);
-    glBindVertexArray(0);
+    // CURSOR LAYER: screen space, drawn over the text
+    m_cursor.setColor(paletteColor(7)); // Default foreground
+    m_cursor.render(m_elapsedTime);
+}
+
+void ParticleSystem::renderCached(const FrameUniforms& frame)
+{
+    int fbWidth = (int)std::lround(m_width * m_pixelRatio);
+    int fbHeight = (int)std::lround(m_height * m_pixelRatio);
+    if (!m_frameCache.resize(fbWidth, fbHeight)) m_cacheValid = false;
+    
+    // Layers are drawn with neutral shimmer: the present pass applies this frame's pulse.
+    // Per-frame jitter / orbit (a few hundredths of a px) is left out of cached frames.
+    FrameUniforms neutral = frame;
+    for (int flag = 0; flag < 2; ++flag) {
+        neutral.shimmer[flag][0] = 1.0f;
+        neutral.shimmer[flag][1] = neutral.shimmer[flag][2] = neutral.shimmer[flag][3] = 0.0f;
+    }
+    for (float& orbit : neutral.orbit) orbit = 0.0f;
+    
+    // Everything the cached pixels depend on: clock and physics parameters excluded
+    FrameUniforms key = neutral;
+    key.elapsedTime = 0.0f;
+    key.deltaTime = 0.0f;
+    key.shimmerSpeed = 0.0f;
+    key.springK = 0.0f;
+    key.drag = 0.0f;
+    if (m_cacheValid && memcmp(&key, &m_cacheKey, sizeof(key)) != 0) m_cacheValid = false;
+    
+    QRect region; // Framebuffer px, bottom-left origin (empty = whole cache)
+    if (!m_cacheValid) {
+        if (!isSettled()) {
+            drawScene(false); // Still animating: nothing worth caching yet
+            return;
+        }
+        m_cacheKey = key;
+        m_cacheDamage = QRectF();
+    } else if (!m_cacheDamage.isEmpty()) {
+        // Scene px -> framebuffer px through the zoomed projection (NDC y points up)
+        QPointF a = m_frameProjection.map(m_cacheDamage.topLeft());
+        QPointF b = m_frameProjection.map(m_cacheDamage.bottomRight());
+        QRectF ndc = QRectF(a, b).normalized();
+        region = QRect(QPoint((int)std::floor((ndc.left() * 0.5 + 0.5) * fbWidth),
+                              (int)std::floor((ndc.top() * 0.5 + 0.5) * fbHeight)),
+                       QPoint((int)std::ceil((ndc.right() * 0.5 + 0.5) * fbWidth),
+                              (int)std::ceil((ndc.bottom() * 0.5 + 0.5) * fbHeight)))
+                 & QRect(0, 0, fbWidth, fbHeight);
+        if (region.isEmpty()) m_cacheDamage = QRectF(); // Off screen at this zoom
+    }
+    
+    m_presentedFromCache = m_cacheValid; // A full rebuild costs like a direct frame
+    if (!m_cacheValid || !region.isEmpty()) {
+        uploadFrameUniforms(neutral);
+        m_frameCache.begin(region);
+        drawScene(true);
+        m_frameCache.end();
+        uploadFrameUniforms(frame); // Present and cursor use the live shimmer
+        
+        m_cacheValid = true;
+        if (isSettled()) m_cacheDamage = QRectF(); // Final positions are in the cache now
+    }
+    
+    m_frameCache.present();
+}
+
+void ParticleSystem::drawScene(bool cacheLayers)
+{
+    // BACKGROUND LAYER: flat runs under the glyph particles
+    if (cacheLayers) m_frameCache.selectBackgroundLayer();
+    m_background.render();
+    if (cacheLayers) m_frameCache.selectParticleLayers();
+    
+    // On-screen particle size picks the renderer: splats, point sprites or instanced quads
+    // (cache layers always take quads: both shimmer groups come out of one pass)
+    float dotPx = m_particleSize * m_zoomLevel * m_pixelRatio;
+    if (m_bloom) dotPx *= 0.5f; // Core-only quads (DOT_EXTENT, look.glsl)
+    bool splat = !cacheLayers && m_splat.isAvailable() && dotPx <= SplatLayer::MAX_DOT_PX;
+    bool points = !cacheLayers && !splat && m_pointProgram && dotPx < POINT_SPRITE_MAX_PX;
+    
+    if (m_useVisibleList) {
+        // Counts come from the compaction pass; shaders pull from the SSBOs
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_motionVbo);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_shapeVbo);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_targetVbo);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_extraVbo);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, m_colorVbo);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 9, m_visibleSsbo);
+    }
+    
+    if (splat) {
+        // SPLAT: compute rasterizer over the visible list, then one resolve pass
+        m_splat.render(m_indirectBuffer, (int)std::lround(m_width * m_pixelRatio),
+                       (int)std::lround(m_height * m_pixelRatio));
+    } else {
+        QOpenGLShaderProgram* program = cacheLayers ? m_cacheProgram : (points ? m_pointProgram : m_renderProgram);
+        program->bind();
+        glBindVertexArray(points ? m_pointVao : m_vao);
+        if (m_useVisibleList) {
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_indirectBuffer);
+            if (points) {
+                // POINT SPRITES: one vertex per particle
+                glEnable(GL_PROGRAM_POINT_SIZE);
+                glDrawArraysIndirect(GL_POINTS, (const void*)(8 * sizeof(GLuint)));
+                glDisable(GL_PROGRAM_POINT_SIZE);
+            } else {
+                glDrawArraysIndirect(GL_TRIANGLE_FAN, nullptr);
+            }
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        } else {
+            glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, 4, m_particleCount);
+        }
+        glBindVertexArray(0);
+    }
 }
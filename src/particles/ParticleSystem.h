@@ -3,15 +3,20 @@
 #include <vector>
 #include <QOpenGLFunctions_4_5_Core>
 #include <QOpenGLShaderProgram>
+#include <QRectF>
 #include <memory>
 #include "../fonts/FontAsset.h"
-#include "../fonts/ClassicFont.h"
-#include "../fonts/HighResFont.h"
-#include "../fonts/TechVectorFont.h"
-#include "../fonts/ModernTermFont.h"
-#include "../fonts/CodeProFont.h"
-#include "../fonts/CrtRetroFont.h"
-#include "../fonts/TechVectorFont.h" // NEW
+#include "GlyphCache.h"
+#include "UploadEngine.h"
+#include "ParticleAllocator.h"
+#include "ParticleBuffers.h"
+#include "CursorLayer.h"
+#include "BackgroundLayer.h"
+#include "SplatLayer.h"
+#include "FrameCache.h"
+#include "../renderer/ShaderManager.h"
+
+class GpuResourcePool;
 
 // SoA Layout for strict cache coherency on CPU (if needed) and direct mapping to GPU buffers
 class ParticleSystem : protected QOpenGLFunctions_4_5_Core
@@ -37,7 +42,7 @@ public:
     };
     
     void init();
-    void resize(int width, int height);
+    void resize(int width, int height, float pixelRatio = 1.0f); // pixelRatio: device px per logical px
     void update(float dt);
     void render(const QMatrix4x4& viewProjection);
     
@@ -49,18 +54,30 @@ public:
     void seedParticles(int count);
     
     // Text Rendering
-    void updateParticlesFromTerminal(const class TerminalModel& model, int cursorX = -1, int cursorY = -1, bool cursorVisible = false,
-                                     int selStartCol = -1, int selStartRow = -1, int selEndCol = -1, int selEndRow = -1,
-                                     int linkRow = -1, int linkStart = -1, int linkEnd = -1);
+    void updateParticlesFromTerminal(const class TerminalModel& model);
                                      
     void triggerShockwave(float x, float y);
     
+    // Cursor layer: cheap to call every frame (uniform state, no regeneration)
+    void setCursor(int col, int row, bool visible);
+    bool isCursorAnimating() const { return m_cursor.isAnimating(m_elapsedTime); }
+    
+    // Render-time overlays in screen cells (-1 = none): no regeneration while dragging or hovering
+    void setSelection(int startCol, int startRow, int endCol, int endRow);
+    void setHoveredLink(int row, int startCol, int endCol);
+    
     void setAudioLevel(float level) { m_audioLevel = level; } 
     float getAudioLevel() const { return m_audioLevel; }
                                      
     void setTheme(int theme); // 0=Cyberpunk, 1=Retro, 2=Synthwave
     void setScanlineIntensity(float val) { m_scanlineIntensity = val; }
     void setColorTint(QVector3D tint) { m_colorTint = tint; }
+    
+    // 256-color palette, resolved on the GPU (UBO): changes never regenerate particles
+    void setPaletteColor(int index, const QVector3D& color); // OSC 4
+    void resetPalette();                // OSC 104 without arguments
+    void resetPaletteColor(int index);  // OSC 104 with an index
+    QVector3D paletteColor(int index) const;
 
     void setGlowIntensity(float val) { m_glowIntensity = val; }
     void setBrightness(float val) { m_brightness = val; }
@@ -71,8 +88,7 @@ public:
     void setDensity(int val) { 
         if (m_density != val) {
             m_density = val; 
-            m_prevGrid.clear(); // Force rebuild
-            m_prevGrid.clear(); // Force rebuild
+            m_prevGrid.clear(); // Force rebuild (templates are keyed by density)
         }
     }
     
@@ -97,33 +113,199 @@ public:
 
     void setAnimationStyle(int style) { m_animationStyle = style; }
 
+    // GPU Cell Expansion: upload compact cells, expand to particles in a compute pass
+    void setGpuExpansion(bool enabled);
+    bool getGpuExpansion() const { return m_gpuExpansion; }
+    
+    // Compact particle layout (25 bytes/particle instead of 65); applied on the next update
+    void setCompactParticles(bool enabled);
+    bool getCompactParticles() const { return m_compactParticles; }
+    
+    // Draw particles as GL_POINTS (one vertex each) while they stay under a few
+    // pixels on screen; needs the visible list. Larger particles keep instanced quads.
+    void setPointSprites(bool enabled);
+    bool getPointSprites() const { return m_pointSprites; }
+    
+    // Compute splat rasterizer (SplatLayer) for particles up to SplatLayer::MAX_DOT_PX;
+    // needs the visible list. Takes precedence over point sprites.
+    void setSplatRendering(bool enabled);
+    bool getSplatRendering() const { return m_splatRendering; }
+    
+    // Post-process bloom is on (TerminalWidget / BloomPass): particles draw their
+    // sharp cores only and glow intensity moves to the composite
+    void setBloom(bool enabled) { m_bloom = enabled; }
+    bool getBloom() const { return m_bloom; }
+    
+    // Static frame cache (FrameCache): settled frames are re-presented from offscreen
+    // layers instead of redrawing every particle; changed cells redraw a scissored region
+    void setFrameCaching(bool enabled);
+    bool getFrameCaching() const { return m_frameCaching; }
+    bool presentedFromCache() const { return m_presentedFromCache; } // Last render reused the cache
+    
+    // Idle detection: true once the GPU reported a frame with no moving particles
+    // after the last regeneration (the count is read back a few frames late)
+    bool isSettled() const;
+    uint32_t getMovingParticles() const { return m_movingParticles; }
+    void advanceClock(float dt) { m_elapsedTime += dt; } // Shimmer time without physics
+    
+    // Upload stats (bytes streamed to the GPU)
+    size_t getUploadBytesLastUpdate() const { return m_uploader.lastFlushBytes(); }
+    size_t getUploadBytesTotal() const { return m_uploader.totalBytes(); }
+
 private:
     void initBuffers();
+    void initParticleBuffers();   // m_particleCapacity particles in the active layout
+    void bindParticleBuffers();   // Cache the stream handles and re-point the VAO
+    void releaseParticleBuffers();
+    void resizeParticleBuffers(int capacity, int preserve);
+    // Grow past the allocator high-water mark (copying preserve particles); shrink after a full rebuild
+    void fitParticleBuffers(bool fullRebuild, int preserve);
     void initShaders();
+    void applyParticleLayout();
+    
+    // CPU generation scratch: only the blocks rewritten by the current update (no full mirror).
+    // reserveScratch returns the scratch index of count zeroed particles.
+    size_t reserveScratch(size_t count);
+    void releaseScratch();
+    void writeParticle(size_t idx, float tx, float ty, float size, float dx, float dy, float dz,
+                       uint32_t color, float pulse, bool text);
+    void hideParticle(size_t idx);
+    
+    // Per-cell particle blocks (released blocks are hidden on the GPU before reuse)
+    bool allocateCellBlock(int count, ParticleAllocator::Block& block);
+    void releaseCellBlock(ParticleAllocator::Block& block);
+
+    // Cell attribute bits packed into the top byte of a cell record (mirrors particle_expand.comp)
+    enum CellAttr : uint32_t {
+        CELL_CHANGED = 2,
+        CELL_VECTOR  = 4
+    };
+
+    // Upload engine streams (bit index = stream id)
+    enum UploadStream {
+        STREAM_MOTION = 0,
+        STREAM_SHAPE,
+        STREAM_TARGET,
+        STREAM_EXTRA,
+        STREAM_COLOR,
+        STREAM_STATE,
+        STREAM_CELLS,
+        STREAM_DIRTY_CELLS,
+        STREAM_CELL_RANGES,
+        STREAM_COUNT
+    };
+    static const unsigned PARTICLE_STREAMS = 0x3F; // motion, shape, target, extra, color, state
+    
+    void flushUploads();
+    void ensureBufferCapacity(GLuint& buffer, int& capacity, int needed, int stride);
+    void dispatchExpansion(int cols, float charWidth, float charHeight);
+    void compactVisible();
+    void wakeAllCells();
+    void wakeDirtyCells();
+    void buildActiveCells();
+    void pollMotionReadback();
+    void queueMotionReadback();
+    float ringY(float screenY) const; // Screen y -> physical (ring) y
+    // Programs for the current style / theme / effect flags (no-op while unchanged)
+    void selectShaderVariants();
+    void writeFrameUniforms(float dt); // Fill + bind the Frame UBO
+    // Backgrounds + particles; cacheLayers = into the FrameCache layers (quads, neutral shimmer)
+    void drawScene(bool cacheLayers);
+    void damageCell(int col, int screenRow); // Cache region the cell's particles can cover
+    void applyPaletteTheme(); // Theme-dependent palette entries
 
     // GPU Buffers
     GLuint m_vao;
-    GLuint m_posVbo;      // Current Position (vec4: x, y, z, w)
-    GLuint m_velVbo;      // Velocity (vec4: vx, vy, vz, vw)
-    GLuint m_targetVbo;   // Target Position (vec4: tx, ty, tz, padding)
-    GLuint m_extraVbo;    // Extra: x=pulse, y=flicker, z=radius, w=unused - NEW
-    GLuint m_colorVbo;    // Color (vec4: r, g, b, a)
+    GLuint m_pointVao = 0; // Attribute-less: point sprites pull everything from the SSBOs
+    ParticleBuffers m_buffers; // Owns the six streams below (handles cached by bindParticleBuffers)
+    GLuint m_motionVbo;   // Hot: position + velocity (vec4: x, y, vx, vy)
+    GLuint m_targetVbo;   // Hot: target position (vec2: tx, ty)
+    GLuint m_stateVbo;    // Hot: state byte (ParticleBuffers::ParticleState)
+    GLuint m_shapeVbo;    // Cold: vec2 (z, size)
+    GLuint m_extraVbo;    // Cold: x=pulse, y=flicker, z=radius, w=text pixel
+    GLuint m_colorVbo;    // Cold: color ref (palette index or truecolor, see paletteRef)
     GLuint m_baseQuadVbo; // The single quad geometry
+    
+    // Particle layout: float = vec4 / vec2 streams, compact = half/fixed-point/RGBA8 (see particle_compute.comp)
+#ifdef AMBER_COMPACT_PARTICLES
+    bool m_compactParticles = true;
+#else
+    bool m_compactParticles = false;
+#endif
+    bool m_layoutCompact = false; // Layout the GL buffers/shaders were built for
 
-    // Shader Programs
-    std::unique_ptr<QOpenGLShaderProgram> m_renderProgram;
-    std::unique_ptr<QOpenGLShaderProgram> m_computeProgram;
+    // Shared programs, fonts, glyph templates and particle budget
+    GpuResourcePool* m_pool = nullptr;
+    uint32_t m_glyphGeneration = 0;
+    
+    // Shader Programs (owned by the pool)
+    QOpenGLShaderProgram* m_renderProgram = nullptr;
+    QOpenGLShaderProgram* m_pointProgram = nullptr; // POINT_SPRITES variant (null while disabled)
+    QOpenGLShaderProgram* m_computeProgram = nullptr;
+    QOpenGLShaderProgram* m_expandProgram = nullptr;
+    QOpenGLShaderProgram* m_compactProgram = nullptr;
+    QOpenGLShaderProgram* m_cellsProgram = nullptr;
+    QOpenGLShaderProgram* m_cellPhysicsProgram = nullptr;
+    
+    // Shader variants: base defines (layout / visible list) + ShaderManager::variantDefines
+    QStringList m_layoutDefines;
+    QStringList m_streamDefines;
+    ShaderVariant m_physicsVariant; // Animation style (compute + expansion)
+    ShaderVariant m_lookVariant;    // Theme + effect flags (render, background, cursor)
+    bool m_variantValid = false;
+    
+    // std140 mirror of the Frame block (shaders/frame.glsl), binding 1
+    struct FrameUniforms {
+        float projection[16];
+        float resolution[2];
+        float cellSize[2];
+        float colorTint[3];
+        float elapsedTime;
+        float shockwave[3];
+        float deltaTime;
+        int32_t selection[4];
+        int32_t link[4];
+        int32_t rowHead;
+        int32_t rows;
+        float shimmerSpeed;
+        float glowIntensity;
+        float brightness;
+        float vibrance;
+        float scanlineIntensity;
+        float springK;
+        float drag;
+        float pointScale;
+        float pad[2];
+        float shimmer[2][4]; // Per shimmer flag: brightness, jitter x, y, unused
+        float orbit[4];      // Flag 0 xy, flag 1 xy
+    };
+    static_assert(sizeof(FrameUniforms) == 240, "FrameUniforms must match the std140 Frame block");
+    void fillFrameUniforms(FrameUniforms& frame, float dt) const;
+    void uploadFrameUniforms(const FrameUniforms& frame);
+    void writeShimmer(FrameUniforms& frame) const; // Per-frame shimmer / jitter / orbit
+    void renderCached(const FrameUniforms& frame); // Refresh the cache where needed, then present it
+    GLuint m_frameUbo = 0;
+    QMatrix4x4 m_frameProjection; // Zoomed projection of the last render
 
     // Data
     int m_particleCount;
-    int m_maxParticles;
+    int m_particleCapacity = 0; // Particles the GL buffers hold (reserved from the pool budget)
     
-    // Member vectors to avoid re-allocation
-    std::vector<float> m_posData;
-    std::vector<float> m_velData;
-    std::vector<float> m_targetData;
-    std::vector<float> m_extraData;
-    std::vector<float> m_colorData;
+    // Dirty-set scratch, float layout (cleared after every flush)
+    std::vector<float> m_scratchMotion; // 4 per particle
+    std::vector<float> m_scratchShape;  // 2 per particle
+    std::vector<float> m_scratchTarget; // 2 per particle
+    std::vector<float> m_scratchExtra;
+    std::vector<float> m_scratchColor;
+    
+    // Dirty-set scratch, compact layout (only the active layout is used)
+    std::vector<uint32_t> m_scratchPackedMotion; // 2 per particle: half2 offset from target, half2 (vx, vy)
+    std::vector<uint32_t> m_scratchPackedShape;  // half2 (z, size)
+    std::vector<uint32_t> m_scratchPackedTarget; // uint16 x, y in 1/8 px (x = 0xFFFF hidden)
+    std::vector<uint32_t> m_scratchPackedExtra;  // RGBA8: pulse, flicker, radius, spawnDelay
+    std::vector<uint32_t> m_scratchPackedColor;  // RGBA8 color ref
+    std::vector<uint8_t> m_scratchState;         // Both layouts (ParticleBuffers::ParticleState)
+    size_t m_scratchCount = 0;
     
     // Bounds
     float m_width;
@@ -131,14 +313,92 @@ private:
     
     // Optimization Settings
     float m_zoomLevel = 1.0f;
+    float m_pixelRatio = 1.0f;
+    bool m_pointSprites = false;
+    bool m_splatRendering = false;
+    bool m_bloom = false;
+    float m_particleSize = 0.0f; // Scene px of the current font's particles
     int m_density = 8; // Increased default density for brightness
     int m_gridCols = 0;
     int m_gridRows = 0;
     int m_gridDensity = 0; // Track density used for allocation
+    float m_gridCellWidth = 10.0f;
+    float m_gridCellHeight = 18.0f; // Row height the targets were generated with
+    
+    CursorLayer m_cursor;
+    BackgroundLayer m_background; // Cell backgrounds (merged quads, not particles)
+    SplatLayer m_splat;           // Compute rasterizer for tiny particles
+    
+    // Static frame cache: valid while the neutral-shimmer Frame block (m_cacheKey),
+    // palette and variants are unchanged; m_cacheDamage is redrawn until particles settle
+    FrameCache m_frameCache;
+    QOpenGLShaderProgram* m_cacheProgram = nullptr; // FRAME_CACHE variant (null while disabled)
+    bool m_frameCaching = false;
+    bool m_cacheValid = false;
+    bool m_presentedFromCache = false;
+    QRectF m_cacheDamage;   // Scene px, screen rows
+    FrameUniforms m_cacheKey = {};
+    
+    // Palette UBO (binding 0): 256 colors + text black, std140 vec4s
+    std::vector<float> m_palette;
+    GLuint m_paletteUbo = 0;
+    bool m_paletteDirty = true;
+    int m_selection[4] = { -1, -1, -1, -1 }; // start col, row, end col, row (reading order)
+    int m_link[3] = { -1, -1, -1 };          // row, first col, last col
+    
+    // ROW RING: cell state and particle targets live in physical rows; screen row r
+    // shows physical row (r + m_rowHead) % rows, applied in particle.vert
+    int m_rowHead = 0;
+    qint64 m_scrollPosition = 0; // Last TerminalModel::scrollPosition() seen
     std::vector<uint32_t> m_prevGrid; // Store char codes to detect changes
     std::vector<uint32_t> m_prevChars; // Store actual character codes for animation triggers
-    std::vector<float> m_jitterTable; // Optimization: Pre-computed random noise
-    int m_jitterIndex = 0;
+    UploadEngine m_uploader; // Dirty-span streaming into the instance buffers
+    
+    // Variable-size cell allocation (cell -> particle range table)
+    ParticleAllocator m_allocator;
+    std::vector<ParticleAllocator::Block> m_cellBlocks;
+    bool m_poolFullWarned = false;
+    bool m_defragPending = false;
+    
+    // GPU Cell Expansion
+    bool m_gpuExpansion = false;
+    GLuint m_cellSsbo = 0;          // uvec4 per cell: glyph slot | attr << 24, fg ref, 0, first | sizeClass << 27
+    GLuint m_dirtyCellSsbo = 0;     // Cell indices to expand this frame
+    int m_cellCapacity = 0;
+    int m_dirtyCellCapacity = 0;
+    std::vector<uint32_t> m_cellData;
+    std::vector<uint32_t> m_dirtyCells;
+    uint32_t m_expandSeed = 0;
+    
+    // Visible-particle compaction: physics + draw run indirectly over live particles only
+    bool m_useVisibleList = false;
+    bool m_visibleDirty = true;     // Particles were (re)generated since the last compaction
+    GLuint m_visibleSsbo = 0;       // uint per live particle: particle id
+    GLuint m_indirectBuffer = 0;    // DrawArraysIndirectCommand + DispatchIndirectCommand
+    int m_visibleCapacity = 0;
+    
+    // Active cells: physics runs per animating cell, settled cells are skipped
+    bool m_fullPhysics = true;          // Last frame ran the full (non-cell) pass
+    std::vector<uint32_t> m_cellRanges; // Per cell: first | sizeClass << 27 (0xFFFFFFFF = none)
+    GLuint m_cellRangeSsbo = 0;
+    GLuint m_cellMotionSsbo = 0;        // Per cell: 1 while still moving (GPU-written)
+    GLuint m_activeCellSsbo = 0;        // Compacted list of moving cells
+    GLuint m_activeIndirectBuffer = 0;  // DispatchIndirectCommand + active count
+    int m_cellRangeCapacity = 0;
+    int m_cellMotionCapacity = 0;
+    int m_activeCellCapacity = 0;
+    
+    // Idle detection: moving-particle counter copied into a readback ring under fences
+    static const int MOTION_READBACK_SLOTS = 4;
+    GLuint m_motionCounter = 0;         // uint, cleared before each physics dispatch
+    GLuint m_motionReadback = 0;        // MOTION_READBACK_SLOTS x uint
+    GLsync m_motionFences[MOTION_READBACK_SLOTS] = {};
+    uint64_t m_motionSlotFrame[MOTION_READBACK_SLOTS] = {};
+    int m_motionSlot = 0;
+    uint64_t m_physicsFrame = 0;        // Incremented per update()
+    uint64_t m_wakeFrame = 1;           // First frame that sees the latest regeneration
+    uint64_t m_motionFrame = 0;         // Frame the last read-back count belongs to
+    uint32_t m_movingParticles = 0;
     
     // Visual Parameters
     float m_glowIntensity = 1.0f;
@@ -0,0 +1,79 @@
+#include "SplatLayer.h"
+#include "../renderer/GpuResourcePool.h"
+#include <QDebug>
+
+// Accumulation words per pixel (splat.glsl: r|g, b|a in 8.8 fixed point)
+static const int WORDS_PER_PIXEL = 2;
+
+SplatLayer::SplatLayer()
+{
+}
+
+SplatLayer::~SplatLayer()
+{
+    if (!m_vao) return;
+    glDeleteVertexArrays(1, &m_vao);
+    glDeleteBuffers(1, &m_accumSsbo);
+}
+
+void SplatLayer::init(GpuResourcePool* pool)
+{
+    initializeOpenGLFunctions();
+    m_pool = pool; // Programs: selectVariant()
+
+    GLint fragmentSsbos = 0;
+    glGetIntegerv(GL_MAX_FRAGMENT_SHADER_STORAGE_BLOCKS, &fragmentSsbos);
+    m_supported = (fragmentSsbos >= 1);
+    if (!m_supported) qWarning() << "SPLAT: No fragment shader storage blocks, splat renderer disabled";
+
+    glCreateVertexArrays(1, &m_vao);
+    glCreateBuffers(1, &m_accumSsbo);
+}
+
+void SplatLayer::selectVariant(const QStringList& streamDefines, const QStringList& lookDefines)
+{
+    m_splatProgram = nullptr;
+    m_resolveProgram = nullptr;
+    if (!m_supported || !streamDefines.contains("VISIBLE_LIST")) return;
+
+    m_splatProgram = m_pool->computeProgram("Splat", "shaders/particle_splat.comp", streamDefines);
+    m_resolveProgram = m_pool->program("SplatResolve", "shaders/fullscreen.vert", "shaders/splat_resolve.frag",
+                                       lookDefines);
+}
+
+void SplatLayer::reserve(qint64 pixels)
+{
+    if (pixels <= m_capacity) return;
+
+    // Grow only: the resolve leaves every pixel it covers zeroed, whatever the stride
+    GLsizeiptr bytes = (GLsizeiptr)pixels * WORDS_PER_PIXEL * sizeof(GLuint);
+    glNamedBufferData(m_accumSsbo, bytes, nullptr, GL_DYNAMIC_COPY);
+    glClearNamedBufferData(m_accumSsbo, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    m_capacity = pixels;
+    qDebug() << "SPLAT: Accumulation buffer" << pixels << "px (" << bytes / (1024 * 1024) << "MB)";
+}
+
+void SplatLayer::render(GLuint indirectBuffer, int framebufferWidth, int framebufferHeight)
+{
+    if (!isAvailable() || framebufferWidth <= 0 || framebufferHeight <= 0) return;
+    reserve((qint64)framebufferWidth * framebufferHeight);
+
+    // 1. SPLAT: one thread per live particle, group count from the compaction pass.
+    // Physics positions and the previous resolve's clears must be visible first.
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    m_splatProgram->bind();
+    glUniform2i(m_splatProgram->uniformLocation("uFramebufferSize"), framebufferWidth, framebufferHeight);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 10, indirectBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, ACCUM_BINDING, m_accumSsbo);
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, indirectBuffer);
+    glDispatchComputeIndirect(4 * sizeof(GLuint));
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    // 2. RESOLVE: look per covered pixel, blended like the particles; clears as it reads
+    m_resolveProgram->bind();
+    glUniform2i(m_resolveProgram->uniformLocation("uFramebufferSize"), framebufferWidth, framebufferHeight);
+    glBindVertexArray(m_vao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QOpenGLFunctions_4_5_Core>
+#include <QOpenGLShaderProgram>
+#include <QStringList>
+
+class GpuResourcePool;
+
+// Compute splat rasterizer for particles only a few pixels across
+// (shaders/particle_splat.comp). Every live particle adds its dot into a
+// fixed-point accumulation buffer with atomics; one fullscreen pass
+// (shaders/splat_resolve.frag) applies the look per pixel and clears the buffer
+// again. Replaces a quad, its helper lanes and discards per particle.
+class SplatLayer : protected QOpenGLFunctions_4_5_Core
+{
+public:
+    // On-screen dot diameter (framebuffer px) up to which splatting is used
+    static constexpr float MAX_DOT_PX = 4.0f;
+    static const GLuint ACCUM_BINDING = 17;
+
+    SplatLayer();
+    ~SplatLayer(); // GL context must be current
+
+    void init(GpuResourcePool* pool);
+    // Program variants: particle layout defines (visible list) + look defines
+    void selectVariant(const QStringList& streamDefines, const QStringList& lookDefines);
+    bool isAvailable() const { return m_splatProgram && m_resolveProgram; }
+
+    // Particle SSBOs (0-4, 9) and the frame / palette blocks are bound by the caller;
+    // indirectBuffer is the compaction pass's draw + dispatch command buffer
+    void render(GLuint indirectBuffer, int framebufferWidth, int framebufferHeight);
+
+private:
+    void reserve(qint64 pixels);
+
+    GpuResourcePool* m_pool = nullptr;
+    QOpenGLShaderProgram* m_splatProgram = nullptr;   // Owned by the pool
+    QOpenGLShaderProgram* m_resolveProgram = nullptr; // Owned by the pool
+    bool m_supported = false; // Fragment stage can write SSBOs (the resolve clears in place)
+    GLuint m_vao = 0;         // Attribute-less fullscreen triangle
+    GLuint m_accumSsbo = 0;
+    qint64 m_capacity = 0;    // Pixels
+};
@@ -0,0 +1,185 @@
+#include "UploadEngine.h"
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+// Mirror spans separated by fewer elements than this are merged into one copy
+static const size_t COALESCE_GAP = 64;
+
+UploadEngine::UploadEngine()
+{
+}
+
+UploadEngine::~UploadEngine()
+{
+    if (!m_staging) return;
+    for (int i = 0; i < RING_SEGMENTS; ++i) {
+        if (m_fences[i]) glDeleteSync(m_fences[i]);
+    }
+    glUnmapNamedBuffer(m_staging);
+    glDeleteBuffers(1, &m_staging);
+}
+
+void UploadEngine::init(size_t segmentBytes)
+{
+    initializeOpenGLFunctions();
+
+    m_segmentBytes = segmentBytes;
+    size_t ringBytes = m_segmentBytes * RING_SEGMENTS;
+
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &m_staging);
+    glNamedBufferStorage(m_staging, ringBytes, nullptr, flags);
+    m_mapped = static_cast<char*>(glMapNamedBufferRange(m_staging, 0, ringBytes, flags));
+
+    if (!m_mapped) {
+        qWarning() << "UploadEngine: persistent mapping failed, falling back to glNamedBufferSubData";
+        glDeleteBuffers(1, &m_staging);
+        m_staging = 0;
+    }
+}
+
+void UploadEngine::markDirty(unsigned streamMask, size_t first, size_t count)
+{
+    markDirty(streamMask, first, count, first);
+}
+
+// Spans merge only when buffer and source stay in step. Gap elements are copied too,
+// so gaps are only bridged for mirrors (source == first): packed scratch holds the
+// dirty set only, its gaps belong to other cells.
+static inline bool canMerge(const UploadEngine::Span& cur, size_t first, size_t source)
+{
+    if (first < cur.first || first - cur.first != source - cur.source) return false;
+    size_t gap = (cur.source == cur.first) ? COALESCE_GAP : 0;
+    return first <= cur.first + cur.count + gap;
+}
+
+void UploadEngine::markDirty(unsigned streamMask, size_t first, size_t count, size_t source)
+{
+    if (count == 0) return;
+    for (int s = 0; s < MAX_STREAMS; ++s) {
+        if (!(streamMask & (1u << s))) continue;
+        std::vector<Span>& spans = m_spans[s];
+
+        // Fast path: grid scans arrive in order, extend the last span
+        if (!spans.empty()) {
+            Span& last = spans.back();
+            if (canMerge(last, first, source)) {
+                last.count = std::max(last.count, first + count - last.first);
+                continue;
+            }
+        }
+        spans.push_back({first, count, source});
+    }
+}
+
+void UploadEngine::clear()
+{
+    for (auto& spans : m_spans) spans.clear();
+}
+
+bool UploadEngine::hasDirty() const
+{
+    for (const auto& spans : m_spans) {
+        if (!spans.empty()) return true;
+    }
+    return false;
+}
+
+void UploadEngine::coalesce(std::vector<Span>& spans)
+{
+    if (spans.size() < 2) return;
+    std::sort(spans.begin(), spans.end(), [](const Span& a, const Span& b) { return a.first < b.first; });
+
+    size_t out = 0;
+    for (size_t i = 1; i < spans.size(); ++i) {
+        Span& cur = spans[out];
+        const Span& next = spans[i];
+        if (canMerge(cur, next.first, next.source)) {
+            cur.count = std::max(cur.count, next.first + next.count - cur.first);
+        } else {
+            spans[++out] = next;
+        }
+    }
+    spans.resize(out + 1);
+}
+
+void UploadEngine::waitSegment(int segment)
+{
+    GLsync& fence = m_fences[segment];
+    if (!fence) return;
+
+    // Block until the GPU consumed this segment's previous copies
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    while (result == GL_TIMEOUT_EXPIRED) {
+        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void UploadEngine::advanceSegment()
+{
+    if (m_cursor > 0) {
+        m_fences[m_segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    m_segment = (m_segment + 1) % RING_SEGMENTS;
+    m_cursor = 0;
+    waitSegment(m_segment);
+}
+
+char* UploadEngine::allocate(size_t bytes, size_t& stagingOffset)
+{
+    // 16-byte alignment keeps vec4 copies friendly
+    m_cursor = (m_cursor + 15) & ~size_t(15);
+    if (m_cursor + bytes > m_segmentBytes) advanceSegment();
+
+    stagingOffset = m_segment * m_segmentBytes + m_cursor;
+    m_cursor += bytes;
+    return m_mapped + stagingOffset;
+}
+
+void UploadEngine::flush(const Source* sources, int streamCount)
+{
+    m_lastFlushBytes = 0;
+    m_lastFlushSpans = 0;
+    if (!hasDirty()) return;
+
+    if (m_staging) waitSegment(m_segment);
+
+    for (int s = 0; s < streamCount && s < MAX_STREAMS; ++s) {
+        std::vector<Span>& spans = m_spans[s];
+        const Source& src = sources[s];
+        if (spans.empty() || !src.buffer || !src.data) { spans.clear(); continue; }
+
+        coalesce(spans);
+        for (const Span& span : spans) {
+            size_t offset = span.first * src.elementBytes;
+            size_t remaining = span.count * src.elementBytes;
+            const char* from = static_cast<const char*>(src.data) + span.source * src.elementBytes;
+            m_lastFlushSpans++;
+            m_lastFlushBytes += remaining;
+
+            if (!m_staging) {
+                glNamedBufferSubData(src.buffer, offset, remaining, from);
+                continue;
+            }
+
+            // Large spans stream through the ring in segment-sized chunks
+            while (remaining > 0) {
+                size_t chunk = std::min(remaining, m_segmentBytes);
+                size_t stagingOffset = 0;
+                char* dst = allocate(chunk, stagingOffset);
+                memcpy(dst, from, chunk);
+                glCopyNamedBufferSubData(m_staging, src.buffer, stagingOffset, offset, chunk);
+                from += chunk;
+                offset += chunk;
+                remaining -= chunk;
+            }
+        }
+        spans.clear();
+    }
+
+    if (m_staging) advanceSegment();
+    m_totalBytes += m_lastFlushBytes;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <QOpenGLFunctions_4_5_Core>
+
+// Streams CPU-side dirty ranges into GPU buffers.
+// Each stream keeps a list of coalesced dirty spans (in elements), read either from a
+// full mirror of the buffer or from a scratch array at its own offset. flush() copies
+// them through a persistent-mapped, triple-buffered staging ring guarded by fences,
+// then issues glCopyNamedBufferSubData into the destination buffers.
+class UploadEngine : protected QOpenGLFunctions_4_5_Core
+{
+public:
+    static const int MAX_STREAMS = 12;
+    static const int RING_SEGMENTS = 3;
+
+    struct Span {
+        size_t first;
+        size_t count;
+        size_t source; // First element in the stream's source data (== first for mirrors)
+    };
+
+    // Destination + CPU source of one stream for a flush
+    struct Source {
+        GLuint buffer = 0;
+        const void* data = nullptr;
+        size_t elementBytes = 0;
+    };
+
+    UploadEngine();
+    ~UploadEngine(); // GL context must be current
+
+    void init(size_t segmentBytes = 8 * 1024 * 1024);
+
+    // Record dirty elements [first, first + count) on every stream in streamMask
+    void markDirty(unsigned streamMask, size_t first, size_t count);
+    // Same, but the data comes from [source, source + count) of the stream's source
+    // (packed scratch that only holds the dirty set)
+    void markDirty(unsigned streamMask, size_t first, size_t count, size_t source);
+    void clear();
+    bool hasDirty() const;
+
+    // Upload all dirty spans; sources[i] describes stream i (null buffer = skip)
+    void flush(const Source* sources, int streamCount);
+
+    // Stats
+    size_t lastFlushBytes() const { return m_lastFlushBytes; }
+    size_t totalBytes() const { return m_totalBytes; }
+    int lastFlushSpans() const { return m_lastFlushSpans; }
+
+private:
+    void coalesce(std::vector<Span>& spans);
+    char* allocate(size_t bytes, size_t& stagingOffset);
+    void advanceSegment();
+    void waitSegment(int segment);
+
+    std::vector<Span> m_spans[MAX_STREAMS];
+
+    // Staging ring
+    GLuint m_staging = 0;
+    char* m_mapped = nullptr;
+    size_t m_segmentBytes = 0;
+    int m_segment = 0;
+    size_t m_cursor = 0; // Offset inside the current segment
+    GLsync m_fences[RING_SEGMENTS] = {};
+
+    size_t m_lastFlushBytes = 0;
+    size_t m_totalBytes = 0;
+    int m_lastFlushSpans = 0;
+};
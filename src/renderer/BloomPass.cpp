@@ -0,0 +1,143 @@
+#include "BloomPass.h"
+#include "GpuResourcePool.h"
+#include <QDebug>
+#include <QVector2D>
+#include <algorithm>
+
+// Bloom targets are this much smaller than the scene per axis (2 = half resolution)
+static const int BLOOM_DOWNSAMPLE = 2;
+
+// Bright extraction: luminance threshold with a soft knee below it (bloom_extract.frag).
+// Text dots clear it; the dimmed cell backgrounds mostly do not.
+static const float BLOOM_THRESHOLD = 0.5f;
+static const float BLOOM_KNEE = 0.25f;
+
+BloomPass::BloomPass()
+{
+}
+
+BloomPass::~BloomPass()
+{
+    if (!m_pool) return;
+    releaseTargets();
+    glDeleteVertexArrays(1, &m_vao);
+    GpuResourcePool::release(m_pool);
+}
+
+void BloomPass::init()
+{
+    initializeOpenGLFunctions();
+    m_pool = GpuResourcePool::acquire();
+
+    m_extractProgram = m_pool->program("BloomExtract", "shaders/fullscreen.vert", "shaders/bloom_extract.frag");
+    m_blurProgram = m_pool->program("BloomBlur", "shaders/fullscreen.vert", "shaders/bloom_blur.frag");
+    m_compositeProgram = m_pool->program("BloomComposite", "shaders/fullscreen.vert", "shaders/bloom_composite.frag");
+    glCreateVertexArrays(1, &m_vao);
+}
+
+void BloomPass::releaseTargets()
+{
+    glDeleteFramebuffers(1, &m_sceneFbo);
+    glDeleteTextures(1, &m_sceneTexture);
+    glDeleteFramebuffers(2, m_bloomFbo);
+    glDeleteTextures(2, m_bloomTexture);
+    m_sceneFbo = m_sceneTexture = 0;
+    m_bloomFbo[0] = m_bloomFbo[1] = 0;
+    m_bloomTexture[0] = m_bloomTexture[1] = 0;
+    m_width = m_height = 0;
+}
+
+void BloomPass::resize(int width, int height)
+{
+    releaseTargets();
+    m_width = width;
+    m_height = height;
+    m_bloomWidth = std::max(1, width / BLOOM_DOWNSAMPLE);
+    m_bloomHeight = std::max(1, height / BLOOM_DOWNSAMPLE);
+
+    // Immutable storage: recreated on resize only. Linear filtering does the
+    // downsample average and the blur's paired taps.
+    auto createTarget = [this](GLuint& fbo, GLuint& texture, int w, int h) {
+        glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+        glTextureStorage2D(texture, 1, GL_RGBA16F, w, h);
+        glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glCreateFramebuffers(1, &fbo);
+        glNamedFramebufferTexture(fbo, GL_COLOR_ATTACHMENT0, texture, 0);
+        return glCheckNamedFramebufferStatus(fbo, GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    };
+    bool complete = createTarget(m_sceneFbo, m_sceneTexture, width, height);
+    for (int i = 0; i < 2; ++i) {
+        complete = createTarget(m_bloomFbo[i], m_bloomTexture[i], m_bloomWidth, m_bloomHeight) && complete;
+    }
+    if (!complete) {
+        qWarning() << "BLOOM: Incomplete framebuffer at" << width << "x" << height << ", bloom disabled";
+        releaseTargets();
+        return;
+    }
+    qDebug() << "BLOOM: Targets" << width << "x" << height << "scene," << m_bloomWidth << "x" << m_bloomHeight << "glow";
+}
+
+bool BloomPass::begin(int width, int height)
+{
+    if (!m_extractProgram || !m_blurProgram || !m_compositeProgram) return false;
+    if (width <= 0 || height <= 0) return false;
+    if (width != m_width || height != m_height) resize(width, height);
+    if (!m_sceneFbo) return false;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_sceneFbo);
+    glViewport(0, 0, m_width, m_height);
+    return true;
+}
+
+void BloomPass::drawFullscreen()
+{
+    glBindVertexArray(m_vao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+void BloomPass::finish(GLuint targetFbo, float intensity)
+{
+    // Every pass overwrites its whole target
+    glDisable(GL_BLEND);
+
+    // 1. EXTRACT: scene -> bloom[0] at reduced resolution
+    glViewport(0, 0, m_bloomWidth, m_bloomHeight);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_bloomFbo[0]);
+    m_extractProgram->bind();
+    m_extractProgram->setUniformValue("uScene", 0);
+    m_extractProgram->setUniformValue("uThreshold", BLOOM_THRESHOLD);
+    m_extractProgram->setUniformValue("uKnee", BLOOM_KNEE);
+    glBindTextureUnit(0, m_sceneTexture);
+    drawFullscreen();
+
+    // 2. BLUR: horizontal bloom[0] -> bloom[1], vertical bloom[1] -> bloom[0]
+    m_blurProgram->bind();
+    m_blurProgram->setUniformValue("uSource", 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_bloomFbo[1]);
+    m_blurProgram->setUniformValue("uStep", QVector2D(1.0f / m_bloomWidth, 0.0f));
+    glBindTextureUnit(0, m_bloomTexture[0]);
+    drawFullscreen();
+    glBindFramebuffer(GL_FRAMEBUFFER, m_bloomFbo[0]);
+    m_blurProgram->setUniformValue("uStep", QVector2D(0.0f, 1.0f / m_bloomHeight));
+    glBindTextureUnit(0, m_bloomTexture[1]);
+    drawFullscreen();
+
+    // 3. COMPOSITE: scene + glow into the widget framebuffer (alpha = scene opacity)
+    glViewport(0, 0, m_width, m_height);
+    glBindFramebuffer(GL_FRAMEBUFFER, targetFbo);
+    m_compositeProgram->bind();
+    m_compositeProgram->setUniformValue("uScene", 0);
+    m_compositeProgram->setUniformValue("uBloom", 1);
+    m_compositeProgram->setUniformValue("uBloomIntensity", intensity);
+    glBindTextureUnit(0, m_sceneTexture);
+    glBindTextureUnit(1, m_bloomTexture[0]);
+    drawFullscreen();
+
+    glBindTextureUnit(0, 0);
+    glBindTextureUnit(1, 0);
+    glBindVertexArray(0);
+    glEnable(GL_BLEND);
+}
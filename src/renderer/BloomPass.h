@@ -0,0 +1,47 @@
+#pragma once
+
+#include <QOpenGLFunctions_4_5_Core>
+#include <QOpenGLShaderProgram>
+
+class GpuResourcePool;
+
+// Post-process glow behind TerminalWidget::renderParticles. The scene (sharp
+// particle cores, see BLOOM in shaders/look.glsl) is drawn into an offscreen
+// target; its bright parts are extracted at half resolution, blurred with a
+// separable Gaussian and added back in one composite pass. The glow radius no
+// longer costs per-particle fill, glow intensity is a single uniform.
+class BloomPass : protected QOpenGLFunctions_4_5_Core
+{
+public:
+    BloomPass();
+    ~BloomPass(); // GL context must be current
+
+    void init();
+
+    // Bind the offscreen scene target (framebuffer px); false when unavailable,
+    // the caller then draws straight into its own framebuffer
+    bool begin(int width, int height);
+    // Extract, blur and composite into targetFbo (the widget framebuffer)
+    void finish(GLuint targetFbo, float intensity);
+
+private:
+    void resize(int width, int height);
+    void releaseTargets();
+    void drawFullscreen();
+
+    GpuResourcePool* m_pool = nullptr;
+    QOpenGLShaderProgram* m_extractProgram = nullptr;   // Owned by the pool
+    QOpenGLShaderProgram* m_blurProgram = nullptr;
+    QOpenGLShaderProgram* m_compositeProgram = nullptr;
+    GLuint m_vao = 0; // Attribute-less fullscreen triangle
+
+    // Full-res scene + two reduced-res ping-pong targets (RGBA16F)
+    GLuint m_sceneFbo = 0;
+    GLuint m_sceneTexture = 0;
+    GLuint m_bloomFbo[2] = {};
+    GLuint m_bloomTexture[2] = {};
+    int m_width = 0;
+    int m_height = 0;
+    int m_bloomWidth = 0;
+    int m_bloomHeight = 0;
+};
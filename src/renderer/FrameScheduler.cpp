@@ -0,0 +1,124 @@
+#include "FrameScheduler.h"
+#include "TerminalWidget.h"
+#include <QWidget>
+#include <QWindow>
+#include <QScreen>
+#include <QGuiApplication>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+// Rate for panes without keyboard focus
+static const qreal UNFOCUSED_FPS = 30.0;
+
+// Fallback tick lags one refresh interval by this much: swaps always arrive first
+static const int FALLBACK_SLACK_MS = 2;
+
+// GPU time left for the compositor, other windows and frame jitter
+static const float GPU_HEADROOM = 0.25f;
+
+// ASYMMETRIC BLINK: ON for 1000ms (solid), OFF for 200ms (explosion duration)
+static const qint64 BLINK_ON_MS = 1000;
+static const qint64 BLINK_PERIOD_MS = 1200;
+
+FrameScheduler::FrameScheduler(QWidget* window)
+    : QObject(window)
+    , m_window(window)
+{
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &FrameScheduler::tick);
+    m_clock.start();
+
+    updateRefreshRate();
+    m_timer.start();
+}
+
+void FrameScheduler::addWidget(TerminalWidget* widget)
+{
+    if (!widget || m_widgets.contains(widget)) return;
+    m_widgets.append(widget);
+    connect(widget, &QObject::destroyed, this, [this, widget]() { m_widgets.removeAll(widget); });
+    connect(widget, &QOpenGLWidget::frameSwapped, this, &FrameScheduler::onFrameSwapped);
+    widget->setCursorBlink(m_blinkOn);
+}
+
+void FrameScheduler::removeWidget(TerminalWidget* widget)
+{
+    m_widgets.removeAll(widget);
+    disconnect(widget, &QOpenGLWidget::frameSwapped, this, &FrameScheduler::onFrameSwapped);
+}
+
+void FrameScheduler::updateRefreshRate()
+{
+    QScreen* screen = m_window ? m_window->screen() : nullptr;
+    if (!screen) screen = QGuiApplication::primaryScreen();
+    qreal rate = screen ? screen->refreshRate() : 60.0;
+    if (rate < 1.0) rate = 60.0;
+    if (qFuzzyCompare(rate, m_refreshRate)) return;
+
+    m_refreshRate = rate;
+    // Swap-paced ticks run at the refresh rate: unfocused panes skip whole vblanks
+    m_unfocusedDivisor = std::max(1, (int)std::lround(rate / UNFOCUSED_FPS));
+    m_timer.setInterval((int)std::ceil(1000.0 / rate) + FALLBACK_SLACK_MS);
+    qDebug() << "FrameScheduler:" << rate << "Hz, unfocused panes every" << m_unfocusedDivisor << "ticks";
+}
+
+bool FrameScheduler::isFocused(const TerminalWidget* widget) const
+{
+    return widget->hasFocus() && widget->isActiveWindow();
+}
+
+float FrameScheduler::targetFps(const TerminalWidget* widget) const
+{
+    if (isFocused(widget)) return (float)m_refreshRate;
+    return (float)(m_refreshRate / m_unfocusedDivisor);
+}
+
+float FrameScheduler::frameBudget(const TerminalWidget* widget) const
+{
+    // Fill cost scales with area: every painted pane gets the same time per pixel
+    double load = 0.0;
+    for (const TerminalWidget* other : m_widgets) {
+        if (!other->isRenderEnabled() || !other->isVisible()) continue;
+        load += (double)other->width() * other->height() * targetFps(other);
+    }
+    double area = (double)widget->width() * widget->height();
+    if (load <= 0.0 || area <= 0.0) return (1.0f - GPU_HEADROOM) / targetFps(widget);
+    return (float)((1.0 - GPU_HEADROOM) * area / load);
+}
+
+void FrameScheduler::onFrameSwapped()
+{
+    if (m_tickQueued) return;
+    m_tickQueued = true;
+    QMetaObject::invokeMethod(this, &FrameScheduler::tick, Qt::QueuedConnection);
+}
+
+void FrameScheduler::tick()
+{
+    m_tickQueued = false;
+    m_timer.start(); // Fallback phase restarts at every tick (swap-paced or not)
+    m_tick++;
+    updateRefreshRate(); // Window may have moved to another screen
+
+    // One blink phase for every pane
+    qint64 phase = m_clock.elapsed() % BLINK_PERIOD_MS;
+    bool blinkOn = phase < BLINK_ON_MS;
+    bool blinkChanged = blinkOn != m_blinkOn;
+    m_blinkOn = blinkOn;
+
+    bool throttledTick = (m_tick % m_unfocusedDivisor) != 0;
+
+    for (TerminalWidget* widget : m_widgets) {
+        widget->pollConnection();
+        if (blinkChanged) widget->setCursorBlink(blinkOn);
+
+        // Occluded: hidden tab, minimized or unexposed window
+        if (!widget->isRenderEnabled() || !widget->isVisible()) continue;
+        QWindow* handle = widget->window()->windowHandle();
+        if (handle && !handle->isExposed()) continue;
+
+        if (throttledTick && !isFocused(widget)) continue;
+        widget->requestFrame();
+    }
+}
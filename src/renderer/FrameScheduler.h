@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QList>
+
+class TerminalWidget;
+class QWidget;
+
+// Drives every TerminalWidget from one tick per presented frame. Ticks follow
+// the window's buffer swaps (QOpenGLWidget::frameSwapped, which returns at
+// vblank), so they stay locked to vsync; a fallback timer just over one refresh
+// interval keeps SSH polling and the blink going while nothing is painted.
+// All panes are scheduled in the same event-loop pass, so the window composes
+// them into a single swap per vsync. Also owns the shared animation clock and
+// the cursor blink phase; unfocused panes run at a reduced rate, hidden or
+// unexposed panes are not painted at all (SSH polling continues for every pane).
+class FrameScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FrameScheduler(QWidget* window);
+
+    void addWidget(TerminalWidget* widget);
+    void removeWidget(TerminalWidget* widget);
+
+    // Shared animation clock (seconds since the scheduler started)
+    double now() const { return m_clock.nsecsElapsed() / 1000000000.0; }
+    bool cursorBlinkOn() const { return m_blinkOn; }
+
+    // Frame rate a pane is scheduled at (quality control target)
+    float targetFps(const TerminalWidget* widget) const;
+    // GPU seconds per frame a pane may spend (dynamic resolution budget): one second
+    // of GPU time, minus headroom, shared by the painted panes in proportion to their
+    // pixels x frame rate
+    float frameBudget(const TerminalWidget* widget) const;
+
+private:
+    void tick();
+    void onFrameSwapped(); // Queue the next tick right after the swap
+    void updateRefreshRate();
+    bool isFocused(const TerminalWidget* widget) const;
+
+    QWidget* m_window;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    QList<TerminalWidget*> m_widgets;
+
+    qreal m_refreshRate = 0.0;
+    int m_unfocusedDivisor = 1; // Unfocused panes paint every Nth tick
+    quint64 m_tick = 0;
+    bool m_tickQueued = false; // One swap-paced tick per composed frame (panes share the swap)
+    bool m_blinkOn = true;
+};
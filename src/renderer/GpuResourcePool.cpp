@@ -0,0 +1,154 @@
+#include "GpuResourcePool.h"
+#include "ShaderManager.h"
+#include "../fonts/ClassicFont.h"
+#include "../fonts/HighResFont.h"
+#include "../fonts/SegmentedFont.h"
+#include "../fonts/TechVectorFont.h"
+#include "../fonts/ModernTermFont.h"
+#include "../fonts/CodeProFont.h"
+#include "../fonts/CrtRetroFont.h"
+#include <QOpenGLContext>
+#include <algorithm>
+
+// GTX 1080 Ti Optimization: hard cap for all panes together
+static const int PARTICLE_BUDGET = 8000000;
+
+// Templates kept before the shared cache is dropped and rebuilt on demand
+static const size_t MAX_GLYPH_TEMPLATES = 16384;
+
+static QHash<QOpenGLContextGroup*, GpuResourcePool*>& pools()
+{
+    static QHash<QOpenGLContextGroup*, GpuResourcePool*> registry;
+    return registry;
+}
+
+GpuResourcePool* GpuResourcePool::acquire()
+{
+    QOpenGLContextGroup* group = QOpenGLContextGroup::currentContextGroup();
+    GpuResourcePool*& pool = pools()[group];
+    if (!pool) pool = new GpuResourcePool(group);
+    pool->m_refCount++;
+    return pool;
+}
+
+void GpuResourcePool::release(GpuResourcePool* pool)
+{
+    if (!pool || --pool->m_refCount > 0) return;
+    pools().remove(pool->m_group);
+    delete pool;
+}
+
+GpuResourcePool::GpuResourcePool(QOpenGLContextGroup* group)
+    : m_group(group)
+    , m_particleBudget(PARTICLE_BUDGET)
+{
+    initializeOpenGLFunctions();
+}
+
+GpuResourcePool::~GpuResourcePool()
+{
+    m_programs.clear(); // QOpenGLShaderProgram frees its GL object while the group is alive
+    glDeleteBuffers(1, &m_glyphTableSsbo);
+    glDeleteBuffers(1, &m_glyphParticleSsbo);
+}
+
+QOpenGLShaderProgram* GpuResourcePool::program(const QString& name, const QString& vertPath,
+                                               const QString& fragPath, const QStringList& defines)
+{
+    QString key = name + "|" + defines.join(',');
+    auto it = m_programs.find(key);
+    if (it != m_programs.end()) return it.value().get();
+
+    std::shared_ptr<QOpenGLShaderProgram> created(ShaderManager::createProgram(name, vertPath, fragPath, defines).release());
+    m_programs.insert(key, created); // Failures are cached too: no recompiles per pane
+    return created.get();
+}
+
+QOpenGLShaderProgram* GpuResourcePool::computeProgram(const QString& name, const QString& computePath,
+                                                      const QStringList& defines)
+{
+    QString key = name + "|" + defines.join(',');
+    auto it = m_programs.find(key);
+    if (it != m_programs.end()) return it.value().get();
+
+    std::shared_ptr<QOpenGLShaderProgram> created(ShaderManager::createComputeProgram(name, computePath, defines).release());
+    m_programs.insert(key, created);
+    return created.get();
+}
+
+FontAsset* GpuResourcePool::font(int id)
+{
+    auto it = m_fonts.find(id);
+    if (it != m_fonts.end()) return it.value().get();
+
+    FontAsset* created = nullptr;
+    switch (id) {
+        case 1: created = new HighResFont(); break;
+        case 2: created = new SegmentedFont(); break;
+        case 3: created = new TechVectorFont(); break;
+        case 4: created = new ModernTermFont(); break;
+        case 5: created = new CodeProFont(); break;
+        case 6: created = new CrtRetroFont(); break;
+        case 0:
+        default: created = new ClassicFont(); break;
+    }
+    m_fonts.insert(id, std::shared_ptr<FontAsset>(created));
+    return created;
+}
+
+void GpuResourcePool::ensureBufferCapacity(GLuint& buffer, int& capacity, int needed, int stride)
+{
+    if (buffer && needed <= capacity) return;
+
+    // Grow geometrically, preserving existing contents
+    int newCapacity = std::max(std::max(needed, capacity * 2), 1024);
+    GLuint newBuffer = 0;
+    glCreateBuffers(1, &newBuffer);
+    glNamedBufferData(newBuffer, (GLsizeiptr)newCapacity * stride, nullptr, GL_DYNAMIC_DRAW);
+    if (buffer) {
+        if (capacity > 0) glCopyNamedBufferSubData(buffer, newBuffer, 0, 0, (GLsizeiptr)capacity * stride);
+        glDeleteBuffers(1, &buffer);
+    }
+    buffer = newBuffer;
+    capacity = newCapacity;
+}
+
+void GpuResourcePool::uploadGlyphTemplates()
+{
+    std::vector<const GlyphTemplate*> pending = m_glyphCache.takePending();
+    if (pending.empty()) return;
+
+    ensureBufferCapacity(m_glyphTableSsbo, m_glyphTableCapacity, m_glyphCache.slotCount(), 4 * sizeof(uint32_t));
+    ensureBufferCapacity(m_glyphParticleSsbo, m_glyphParticleCapacity, m_glyphCache.gpuParticleCount(), 4 * sizeof(float));
+
+    std::vector<float> staging;
+    for (const GlyphTemplate* t : pending) {
+        uint32_t entry[4] = { (uint32_t)t->gpuBase, (uint32_t)t->fgCount, (uint32_t)t->count(), 0 };
+        glNamedBufferSubData(m_glyphTableSsbo, (GLintptr)t->slot * sizeof(entry), sizeof(entry), entry);
+        if (t->count() == 0) continue;
+
+        // Flags travel in the unused z component
+        staging.assign(t->offsets.begin(), t->offsets.end());
+        for (int i = 0; i < t->count(); ++i) staging[i*4 + 2] = (float)t->flags[i];
+        glNamedBufferSubData(m_glyphParticleSsbo, (GLintptr)t->gpuBase * 4 * sizeof(float),
+                             staging.size() * sizeof(float), staging.data());
+    }
+
+    // Other panes' contexts read these buffers: make the writes visible across the group
+    glFlush();
+}
+
+void GpuResourcePool::trimGlyphCache()
+{
+    if (m_glyphCache.size() <= MAX_GLYPH_TEMPLATES) return;
+    m_glyphCache.clear();
+    m_glyphGeneration++;
+}
+
+int GpuResourcePool::resizeReservation(int current, int wanted)
+{
+    m_particlesReserved -= current;
+    int granted = std::max(0, std::min(wanted, availableParticles()));
+    m_particlesReserved += granted;
+    return granted;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QOpenGLFunctions_4_5_Core>
+#include <QOpenGLShaderProgram>
+#include <QStringList>
+#include <QHash>
+#include <memory>
+#include "../particles/GlyphCache.h"
+
+class FontAsset;
+class QOpenGLContextGroup;
+
+// GL objects shared by every pane of one context share group (Qt::AA_ShareOpenGLContexts):
+// compiled shader programs, font assets, the glyph template cache with its SSBOs,
+// and the particle budget all panes draw their storage from.
+// Reference counted per share group; the last release() frees the GL objects.
+class GpuResourcePool : protected QOpenGLFunctions_4_5_Core
+{
+public:
+    // Pool of the current context's share group (created on first use)
+    static GpuResourcePool* acquire();
+    static void release(GpuResourcePool* pool); // A context of the group must be current
+
+    // Programs are compiled once per (name, defines); null when compilation failed
+    QOpenGLShaderProgram* program(const QString& name, const QString& vertPath, const QString& fragPath,
+                                  const QStringList& defines = QStringList());
+    QOpenGLShaderProgram* computeProgram(const QString& name, const QString& computePath,
+                                         const QStringList& defines = QStringList());
+
+    // Font assets by id (order of the font list in GraphicsSettingsDialog)
+    FontAsset* font(int id);
+
+    // Glyph templates: keyed by font, density and cell size, so panes with
+    // different settings share one cache. Templates only reach the GPU once.
+    GlyphCache& glyphCache() { return m_glyphCache; }
+    void uploadGlyphTemplates();
+    GLuint glyphTableSsbo() const { return m_glyphTableSsbo; }       // uvec4 per template: first particle, fgCount, count, 0
+    GLuint glyphParticleSsbo() const { return m_glyphParticleSsbo; } // vec4 per template particle: x, y, flags, size
+
+    // Drops the cache once it outgrows its limit; panes rebuild when the generation changes
+    void trimGlyphCache();
+    uint32_t glyphGeneration() const { return m_glyphGeneration; }
+
+    // Particle budget (particles, any layout) shared by all panes.
+    // Releases current and grants up to wanted; returns the new reservation.
+    int resizeReservation(int current, int wanted);
+    int availableParticles() const { return m_particleBudget - m_particlesReserved; }
+
+private:
+    GpuResourcePool(QOpenGLContextGroup* group);
+    ~GpuResourcePool();
+
+    void ensureBufferCapacity(GLuint& buffer, int& capacity, int needed, int stride);
+
+    QOpenGLContextGroup* m_group;
+    int m_refCount = 0;
+
+    QHash<QString, std::shared_ptr<QOpenGLShaderProgram>> m_programs;
+    QHash<int, std::shared_ptr<FontAsset>> m_fonts;
+
+    GlyphCache m_glyphCache;
+    GLuint m_glyphTableSsbo = 0;
+    GLuint m_glyphParticleSsbo = 0;
+    int m_glyphTableCapacity = 0;
+    int m_glyphParticleCapacity = 0;
+    uint32_t m_glyphGeneration = 0;
+
+    int m_particleBudget;
+    int m_particlesReserved = 0;
+};
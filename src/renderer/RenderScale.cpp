@@ -0,0 +1,186 @@
+#include "RenderScale.h"
+#include "GpuResourcePool.h"
+#include <QDebug>
+#include <QVector2D>
+#include <algorithm>
+#include <cmath>
+
+// Scale moves in these steps: a handful of target sizes, each reallocation is rare
+static const float SCALE_STEP = 0.05f;
+
+// Dead band around the budget (fraction of it): above HIGH the scale drops,
+// below LOW it rises one step, in between it holds
+static const float BUDGET_HIGH = 0.95f;
+static const float BUDGET_LOW = 0.6f;
+// Scaling down aims here, leaving room before the next drop
+static const float BUDGET_AIM = 0.8f;
+
+// Frame time smoothing and samples to wait after a step (targets and caches refill)
+static const float FRAME_TIME_SMOOTHING = 0.1f;
+static const int COOLDOWN_DOWN = 15;
+static const int COOLDOWN_UP = 60;
+
+// Unsharp mask strength of the upscale (0 = plain bilinear)
+static const float SHARPNESS = 0.6f;
+
+RenderScale::RenderScale()
+{
+}
+
+RenderScale::~RenderScale()
+{
+    if (!m_pool) return;
+    releaseTarget();
+    glDeleteQueries(TIMER_SLOTS, m_timers);
+    glDeleteVertexArrays(1, &m_vao);
+    GpuResourcePool::release(m_pool);
+}
+
+void RenderScale::init()
+{
+    initializeOpenGLFunctions();
+    m_pool = GpuResourcePool::acquire();
+
+    m_upscaleProgram = m_pool->program("Upscale", "shaders/fullscreen.vert", "shaders/upscale.frag");
+    glCreateVertexArrays(1, &m_vao);
+    glCreateQueries(GL_TIME_ELAPSED, TIMER_SLOTS, m_timers);
+}
+
+void RenderScale::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled) return;
+    m_enabled = enabled;
+    m_scale = MAX_SCALE;
+    m_frameTime = -1.0f;
+    m_cooldown = 0;
+}
+
+void RenderScale::beginFrame()
+{
+    m_timing = false;
+    if (!m_enabled || !m_pool) return;
+    if (m_timerPending[m_timerSlot]) return; // Ring full: skip timing this frame
+    glBeginQuery(GL_TIME_ELAPSED, m_timers[m_timerSlot]);
+    m_timing = true;
+}
+
+void RenderScale::endFrame(float budget, bool sample)
+{
+    if (!m_timing) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    m_timerPending[m_timerSlot] = true;
+    m_timerSample[m_timerSlot] = sample;
+    m_timerSlot = (m_timerSlot + 1) % TIMER_SLOTS;
+    m_timing = false;
+    m_budget = budget;
+    pollTimers();
+}
+
+void RenderScale::pollTimers()
+{
+    // Results complete in order: stop at the first one still in flight
+    while (m_timerPending[m_timerOldest]) {
+        GLuint available = 0;
+        glGetQueryObjectuiv(m_timers[m_timerOldest], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(m_timers[m_timerOldest], GL_QUERY_RESULT, &elapsed);
+        m_timerPending[m_timerOldest] = false;
+        m_timerOldest = (m_timerOldest + 1) % TIMER_SLOTS;
+        if (m_timerSample[m_timerOldest]) adjust((float)(elapsed * 1e-9), m_budget);
+    }
+}
+
+void RenderScale::adjust(float frameTime, float budget)
+{
+    if (m_frameTime < 0.0f) m_frameTime = frameTime;
+    m_frameTime += (frameTime - m_frameTime) * FRAME_TIME_SMOOTHING;
+    if (m_cooldown > 0) {
+        --m_cooldown;
+        return;
+    }
+    if (budget <= 0.0f) return;
+
+    float scale = m_scale;
+    if (m_frameTime > budget * BUDGET_HIGH) {
+        // Fill-bound: time follows the pixel count (scale squared), aim below the budget
+        float fit = m_scale * std::sqrt(budget * BUDGET_AIM / m_frameTime);
+        scale = std::min(m_scale - SCALE_STEP, std::floor(fit / SCALE_STEP) * SCALE_STEP);
+    } else if (m_frameTime < budget * BUDGET_LOW) {
+        scale = m_scale + SCALE_STEP; // Creep back up: one step at a time
+    }
+    scale = std::max(MIN_SCALE, std::min(MAX_SCALE, scale));
+    if (std::fabs(scale - m_scale) < SCALE_STEP * 0.5f) return;
+
+    // Expected time at the new scale, so the next decision does not act on stale samples
+    m_frameTime *= (scale * scale) / (m_scale * m_scale);
+    m_cooldown = (scale < m_scale) ? COOLDOWN_DOWN : COOLDOWN_UP;
+    m_scale = scale;
+}
+
+void RenderScale::releaseTarget()
+{
+    glDeleteFramebuffers(1, &m_fbo);
+    glDeleteTextures(1, &m_texture);
+    m_fbo = m_texture = 0;
+    m_width = m_height = 0;
+}
+
+void RenderScale::resize(int width, int height)
+{
+    releaseTarget();
+
+    // Linear filtering: the upscale taps between scene pixels
+    glCreateTextures(GL_TEXTURE_2D, 1, &m_texture);
+    glTextureStorage2D(m_texture, 1, GL_RGBA16F, width, height);
+    glTextureParameteri(m_texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(m_texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(m_texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(m_texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glCreateFramebuffers(1, &m_fbo);
+    glNamedFramebufferTexture(m_fbo, GL_COLOR_ATTACHMENT0, m_texture, 0);
+    if (glCheckNamedFramebufferStatus(m_fbo, GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        qWarning() << "RENDER SCALE: Incomplete framebuffer at" << width << "x" << height << ", drawing at native resolution";
+        releaseTarget();
+        return;
+    }
+    m_width = width;
+    m_height = height;
+}
+
+bool RenderScale::begin(int width, int height, float pixelRatio)
+{
+    if (!m_enabled || !m_upscaleProgram || m_scale >= MAX_SCALE) return false;
+
+    // Same float product as ParticleSystem's framebuffer size: splat and cache targets match
+    float ratio = pixelRatio * m_scale;
+    int sceneWidth = (int)std::lround((float)width * ratio);
+    int sceneHeight = (int)std::lround((float)height * ratio);
+    if (sceneWidth <= 0 || sceneHeight <= 0) return false;
+    if (sceneWidth != m_width || sceneHeight != m_height || !m_fbo) resize(sceneWidth, sceneHeight);
+    if (!m_fbo) return false;
+    m_pixelRatio = ratio;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    glViewport(0, 0, m_width, m_height);
+    return true;
+}
+
+void RenderScale::finish(GLuint targetFbo, int targetWidth, int targetHeight)
+{
+    // Overwrites the whole widget framebuffer (alpha = scene opacity)
+    glDisable(GL_BLEND);
+    glViewport(0, 0, targetWidth, targetHeight);
+    glBindFramebuffer(GL_FRAMEBUFFER, targetFbo);
+
+    m_upscaleProgram->bind();
+    m_upscaleProgram->setUniformValue("uScene", 0);
+    m_upscaleProgram->setUniformValue("uTexel", QVector2D(1.0f / m_width, 1.0f / m_height));
+    m_upscaleProgram->setUniformValue("uSharpness", SHARPNESS);
+    glBindTextureUnit(0, m_texture);
+    glBindVertexArray(m_vao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glBindTextureUnit(0, 0);
+    glEnable(GL_BLEND);
+}
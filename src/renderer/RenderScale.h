@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QOpenGLFunctions_4_5_Core>
+#include <QOpenGLShaderProgram>
+
+class GpuResourcePool;
+
+// Dynamic resolution behind TerminalWidget::renderParticles. GPU timer queries
+// measure each frame of the pane; when it overruns its budget the scene is drawn
+// into a reduced offscreen target and upscaled with a sharpening filter
+// (shaders/upscale.frag). The scale moves in steps between MIN_SCALE and
+// MAX_SCALE with a dead band and a cooldown, so it does not hunt.
+class RenderScale : protected QOpenGLFunctions_4_5_Core
+{
+public:
+    static constexpr float MIN_SCALE = 0.5f; // Per axis (a quarter of the pixels)
+    static constexpr float MAX_SCALE = 1.0f; // Native: drawn straight into the widget
+
+    RenderScale();
+    ~RenderScale(); // GL context must be current
+
+    void init();
+    void setEnabled(bool enabled); // Off: native resolution, no timing
+    bool isEnabled() const { return m_enabled; }
+    float scale() const { return m_scale; }
+
+    // GPU time of everything the pane draws between the two calls. budget = seconds
+    // per frame this pane may spend (FrameScheduler::frameBudget); results are read
+    // a few frames late, never waited on. sample = false drops the frame's time:
+    // idle and cached frames are nearly free and would walk the scale back up.
+    void beginFrame();
+    void endFrame(float budget, bool sample);
+
+    // Bind the scaled target for a widget of width x height logical px; false at
+    // native scale (the caller draws into its own framebuffer). Scene size and
+    // pixel ratio are valid after a true return.
+    bool begin(int width, int height, float pixelRatio);
+    int sceneWidth() const { return m_width; }
+    int sceneHeight() const { return m_height; }
+    float scenePixelRatio() const { return m_pixelRatio; } // Device ratio x scale
+    GLuint framebuffer() const { return m_fbo; }
+    // Upscale + sharpen into targetFbo (targetWidth x targetHeight framebuffer px)
+    void finish(GLuint targetFbo, int targetWidth, int targetHeight);
+
+private:
+    void resize(int width, int height);
+    void releaseTarget();
+    void pollTimers();
+    void adjust(float frameTime, float budget);
+
+    GpuResourcePool* m_pool = nullptr;
+    QOpenGLShaderProgram* m_upscaleProgram = nullptr; // Owned by the pool
+    GLuint m_vao = 0; // Attribute-less fullscreen triangle
+
+    GLuint m_fbo = 0;
+    GLuint m_texture = 0;
+    int m_width = 0;
+    int m_height = 0;
+    float m_pixelRatio = 1.0f;
+
+    // Frame timing: GL_TIME_ELAPSED queries in a ring, read once available
+    static const int TIMER_SLOTS = 4;
+    GLuint m_timers[TIMER_SLOTS] = {};
+    bool m_timerPending[TIMER_SLOTS] = {};
+    bool m_timerSample[TIMER_SLOTS] = {}; // Result feeds the controller
+    int m_timerSlot = 0;    // Next slot to issue
+    int m_timerOldest = 0;  // Oldest pending slot
+    bool m_timing = false;  // A query is open for this frame
+    float m_budget = 0.0f;  // Latest budget (applies to the results as they arrive)
+
+    // Controller state
+    bool m_enabled = false;
+    float m_scale = MAX_SCALE;
+    float m_frameTime = -1.0f; // Smoothed GPU seconds per frame (< 0 = no sample yet)
+    int m_cooldown = 0;        // Samples to wait before the next step
+};
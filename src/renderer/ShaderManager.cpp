@@ -1,10 +1,22 @@
 #include "ShaderManager.h"
 #include <QFile>
+#include <QFileInfo>
 #include <QDebug>
 #include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <cstring>
 
 static QString resolvePath(const QString& relativePath) {
-    // Try relative to executable first
+    // Embedded resources first (CMakeLists.txt: qt_add_resources)
+    QString resourcePath = ":/" + relativePath;
+    if (QFile::exists(resourcePath)) return resourcePath;
+    
+    // Try relative to executable
     QString exePath = QCoreApplication::applicationDirPath() + "/" + relativePath;
     if (QFile::exists(exePath)) return exePath;
     
@@ -12,20 +24,111 @@ static QString resolvePath(const QString& relativePath) {
     return relativePath;
 }
 
+QStringList ShaderManager::variantDefines(const ShaderVariant& variant)
+{
+    QStringList defines;
+    if (variant.style >= 0) defines << QString("ANIM_STYLE %1").arg(variant.style);
+    if (variant.theme >= 0) defines << QString("THEME %1").arg(variant.theme);
+    if (variant.flags & ShaderVariant::SCANLINES) defines << "SCANLINES";
+    if (variant.flags & ShaderVariant::BLOOM) defines << "BLOOM";
+    return defines;
+}
+
+QByteArray ShaderManager::loadSource(const QString& path, int depth)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "Failed to open shader" << path;
+        return QByteArray();
+    }
+    QByteArray source = file.readAll();
+    if (depth > 4 || !source.contains("#include")) return source;
+    
+    // #include "file": relative to the including shader
+    QString dir = QFileInfo(path).absolutePath();
+    const QList<QByteArray> lines = source.split('\n');
+    QByteArray expanded;
+    for (const QByteArray& line : lines) {
+        QByteArray trimmed = line.trimmed();
+        if (trimmed.startsWith("#include")) {
+            int open = trimmed.indexOf('"');
+            int close = trimmed.lastIndexOf('"');
+            if (open >= 0 && close > open) {
+                QString include = QString::fromUtf8(trimmed.mid(open + 1, close - open - 1));
+                expanded += loadSource(dir + "/" + include, depth + 1);
+                expanded += '\n';
+                continue;
+            }
+        }
+        expanded += line;
+        expanded += '\n';
+    }
+    return expanded;
+}
+
+QByteArray ShaderManager::preprocess(const QString& path, const QStringList& defines)
+{
+    QByteArray source = loadSource(resolvePath(path));
+    if (source.isEmpty()) return source;
+    
+    // #version must stay the first directive: inject defines on the line after it
+    QByteArray defineBlock;
+    for (const QString& define : defines) defineBlock += "#define " + define.toUtf8() + "\n";
+    int versionEnd = source.startsWith("#version") ? source.indexOf('\n') + 1 : 0;
+    source.insert(versionEnd, defineBlock);
+    return source;
+}
+
 std::unique_ptr<QOpenGLShaderProgram> ShaderManager::createProgram(const QString& name, 
                                                                  const QString& vertPath, 
-                                                                 const QString& fragPath)
+                                                                 const QString& fragPath,
+                                                                 const QStringList& defines)
 {
-    auto program = std::make_unique<QOpenGLShaderProgram>();
+    std::vector<Stage> stages = {
+        { QOpenGLShader::Vertex, preprocess(vertPath, defines) },
+        { QOpenGLShader::Fragment, preprocess(fragPath, defines) }
+    };
+    return buildProgram(name, stages);
+}
+
+std::unique_ptr<QOpenGLShaderProgram> ShaderManager::createComputeProgram(const QString& name,
+                                                                        const QString& computePath,
+                                                                        const QStringList& defines)
+{
+    std::vector<Stage> stages = {
+        { QOpenGLShader::Compute, preprocess(computePath, defines) }
+    };
+    return buildProgram(name, stages);
+}
+
+std::unique_ptr<QOpenGLShaderProgram> ShaderManager::buildProgram(const QString& name,
+                                                                const std::vector<Stage>& stages)
+{
+    for (const Stage& stage : stages) {
+        if (stage.source.isEmpty()) {
+            qWarning() << "Missing shader source for" << name;
+            return nullptr;
+        }
+    }
     
-    if (!program->addShaderFromSourceFile(QOpenGLShader::Vertex, resolvePath(vertPath))) {
-        qWarning() << "Failed to compile vertex shader for" << name << ":" << program->log();
-        return nullptr;
+    QString cachePath = binaryCachePath(stages);
+    if (!cachePath.isEmpty()) {
+        auto cached = std::make_unique<QOpenGLShaderProgram>();
+        if (loadBinary(cached.get(), cachePath)) return cached;
     }
     
-    if (!program->addShaderFromSourceFile(QOpenGLShader::Fragment, resolvePath(fragPath))) {
-        qWarning() << "Failed to compile fragment shader for" << name << ":" << program->log();
-        return nullptr;
+    auto program = std::make_unique<QOpenGLShaderProgram>();
+    for (const Stage& stage : stages) {
+        if (!program->addShaderFromSourceCode(stage.type, stage.source)) {
+            qWarning() << "Failed to compile shader for" << name << ":" << program->log();
+            return nullptr;
+        }
+    }
+    
+    // Must be set before linking for glGetProgramBinary to return anything
+    if (!cachePath.isEmpty()) {
+        QOpenGLContext::currentContext()->extraFunctions()->glProgramParameteri(
+            program->programId(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     }
     
     if (!program->link()) {
@@ -33,23 +136,99 @@ std::unique_ptr<QOpenGLShaderProgram> ShaderManager::createProgram(const QString
         return nullptr;
     }
     
+    if (!cachePath.isEmpty()) saveBinary(program.get(), cachePath);
     return program;
 }
 
-std::unique_ptr<QOpenGLShaderProgram> ShaderManager::createComputeProgram(const QString& name,
-                                                                        const QString& computePath)
+// -------------------------------------------------------------------------
+// PROGRAM BINARY CACHE
+// -------------------------------------------------------------------------
+// File: BINARY_MAGIC, binary format (GLenum), driver blob. The name is the key, so
+// a new driver or any source / define change simply misses and writes a new entry.
+
+static const quint32 BINARY_MAGIC = 0x42535041; // "APSB"
+
+QString ShaderManager::binaryCachePath(const std::vector<Stage>& stages)
 {
-    auto program = std::make_unique<QOpenGLShaderProgram>();
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if (!context) return QString();
     
-    if (!program->addShaderFromSourceFile(QOpenGLShader::Compute, resolvePath(computePath))) {
-        qWarning() << "Failed to compile compute shader for" << name << ":" << program->log();
-        return nullptr;
+    QOpenGLFunctions* f = context->functions();
+    GLint formats = 0;
+    f->glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats <= 0) return QString();
+    
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (dir.isEmpty()) return QString();
+    dir += "/shaders";
+    
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(reinterpret_cast<const char*>(f->glGetString(GL_VENDOR)));
+    hash.addData(reinterpret_cast<const char*>(f->glGetString(GL_RENDERER)));
+    hash.addData(reinterpret_cast<const char*>(f->glGetString(GL_VERSION)));
+    for (const Stage& stage : stages) {
+        hash.addData(QByteArray::number((int)stage.type));
+        hash.addData(stage.source);
     }
+    return dir + "/" + QString::fromLatin1(hash.result().toHex()) + ".bin";
+}
+
+bool ShaderManager::loadBinary(QOpenGLShaderProgram* program, const QString& cachePath)
+{
+    QFile file(cachePath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+    QByteArray data = file.readAll();
+    file.close();
     
-    if (!program->link()) {
-        qWarning() << "Failed to link compute program" << name << ":" << program->log();
-        return nullptr;
+    const int header = 2 * sizeof(quint32);
+    quint32 magic = 0;
+    quint32 format = 0;
+    if (data.size() > header) {
+        memcpy(&magic, data.constData(), sizeof(quint32));
+        memcpy(&format, data.constData() + sizeof(quint32), sizeof(quint32));
     }
     
-    return program;
+    // With no shaders attached, link() only reports the status left by glProgramBinary
+    bool linked = magic == BINARY_MAGIC && program->create();
+    if (linked) {
+        QOpenGLContext::currentContext()->extraFunctions()->glProgramBinary(
+            program->programId(), format, data.constData() + header, data.size() - header);
+        linked = program->link();
+    }
+    
+    if (!linked) {
+        qDebug() << "SHADER CACHE: stale binary, recompiling" << cachePath;
+        QFile::remove(cachePath);
+    }
+    return linked;
+}
+
+void ShaderManager::saveBinary(QOpenGLShaderProgram* program, const QString& cachePath)
+{
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    GLuint id = program->programId();
+    
+    GLint length = 0;
+    context->functions()->glGetProgramiv(id, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+    
+    const int header = 2 * sizeof(quint32);
+    QByteArray data(header + length, Qt::Uninitialized);
+    GLenum format = 0;
+    GLsizei written = 0;
+    context->extraFunctions()->glGetProgramBinary(id, length, &written, &format, data.data() + header);
+    if (written <= 0) return;
+    data.resize(header + written);
+    
+    quint32 magic = BINARY_MAGIC;
+    quint32 format32 = format;
+    memcpy(data.data(), &magic, sizeof(quint32));
+    memcpy(data.data() + sizeof(quint32), &format32, sizeof(quint32));
+    
+    // QSaveFile: a crash mid-write never leaves a truncated entry behind
+    QDir().mkpath(QFileInfo(cachePath).absolutePath());
+    QSaveFile file(cachePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qWarning() << "SHADER CACHE: failed to write" << cachePath;
+    }
 }
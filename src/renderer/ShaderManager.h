@@ -3,15 +3,65 @@
 #include <QOpenGLShader>
 #include <QOpenGLShaderProgram>
 #include <QString>
+#include <QStringList>
 #include <memory>
+#include <vector>
+
+// Compile-time specialization of the particle shaders: each combination is its own
+// program, compiled on first use and cached by GpuResourcePool (key = name + defines).
+// Replaces per-particle / per-fragment branches on uniforms that change rarely.
+struct ShaderVariant
+{
+    enum Flag {
+        SCANLINES = 1 << 0, // particle.frag scanline pass (intensity > 0)
+        BLOOM = 1 << 1      // Core-only dots, glow from the post-process (BloomPass)
+    };
+
+    int style = -1; // ANIM_STYLE (physics / expansion), -1 = not specialized
+    int theme = -1; // THEME (particle.frag), -1 = not specialized
+    int flags = 0;
+
+    bool operator==(const ShaderVariant& o) const {
+        return style == o.style && theme == o.theme && flags == o.flags;
+    }
+    bool operator!=(const ShaderVariant& o) const { return !(*this == o); }
+};
 
 class ShaderManager
 {
 public:
+    // Defines selecting a variant, appended to a program's base defines
+    static QStringList variantDefines(const ShaderVariant& variant);
+
+    // defines: injected as "#define X" lines right after the #version directive
+    // ("NAME VALUE" defines a value). #include "file" lines are expanded from the
+    // shader's directory (shared blocks such as shaders/frame.glsl).
+    // Sources come from the embedded resources (:/shaders/...), the filesystem is
+    // only a fallback. Linked programs are cached on disk as driver binaries, keyed
+    // by GL vendor / renderer / version and the final sources; a rejected binary
+    // (driver update) falls back to compiling from source and replaces the entry.
     static std::unique_ptr<QOpenGLShaderProgram> createProgram(const QString& name, 
                                                              const QString& vertPath, 
-                                                             const QString& fragPath);
+                                                             const QString& fragPath,
+                                                             const QStringList& defines = QStringList());
     
     static std::unique_ptr<QOpenGLShaderProgram> createComputeProgram(const QString& name,
-                                                                    const QString& computePath);
+                                                                    const QString& computePath,
+                                                                    const QStringList& defines = QStringList());
+
+private:
+    struct Stage {
+        QOpenGLShader::ShaderType type;
+        QByteArray source; // Includes expanded, defines injected
+    };
+
+    static QByteArray loadSource(const QString& path, int depth = 0);
+    static QByteArray preprocess(const QString& path, const QStringList& defines);
+    static std::unique_ptr<QOpenGLShaderProgram> buildProgram(const QString& name,
+                                                            const std::vector<Stage>& stages);
+
+    // PROGRAM BINARY CACHE
+    static QString binaryCachePath(const std::vector<Stage>& stages); // Empty = cache unavailable
+    static bool loadBinary(QOpenGLShaderProgram* program, const QString& cachePath);
+    static void saveBinary(QOpenGLShaderProgram* program, const QString& cachePath);
 };
@@ -1,5 +1,8 @@
 #include "TerminalWidget.h"
 #include "../particles/ParticleSystem.h"
+#include "FrameScheduler.h"
+#include "BloomPass.h"
+#include "RenderScale.h"
 #include <QDebug>
 #include <QMatrix4x4>
 #include <QClipboard>
@@ -10,11 +13,17 @@
 #include <QUrl>
 #include <QtMath> 
 
+// Settled frames (with the GPU motion count at zero) before the widget goes idle
+static const int IDLE_FRAME_THRESHOLD = 30;
+// Repaint interval for the shimmer while idle (0.1 s = 10 FPS)
+static const int IDLE_SHIMMER_INTERVAL_MS = 100;
+
 TerminalWidget::TerminalWidget(QWidget* parent)
     : QOpenGLWidget(parent)
-    , m_frameTimer(new QTimer(this))
     , m_frameCount(0)
     , m_particleSystem(new ParticleSystem())
+    , m_bloomPass(new BloomPass())
+    , m_renderScale(new RenderScale())
     , m_sshClient(new SshClient(this))
     , m_terminalModel(new TerminalModel(80, 25, this))
     , m_parent(parent)
@@ -30,47 +39,33 @@ TerminalWidget::TerminalWidget(QWidget* parent)
     // Connect Terminal -> Particles (Render Update)
     connect(m_terminalModel, &TerminalModel::screenChanged, this, [this]() {
         m_screenDirty = true;
+        wakeUp();
     });
     
-    // Connect poll timer
-    connect(m_frameTimer, &QTimer::timeout, m_sshClient, &SshClient::poll);
-    
-    // 120 FPS target -> ~8.33ms
-    m_frameTimer->setInterval(8); 
-    connect(m_frameTimer, &QTimer::timeout, this, [this]() {
-        update(); // Schedules paintGL
+    // Palette OSCs: one UBO update, no particle regeneration
+    connect(m_terminalModel, &TerminalModel::paletteColorChanged, this, [this](int index, quint8 r, quint8 g, quint8 b) {
+        m_particleSystem->setPaletteColor(index, QVector3D(r / 255.0f, g / 255.0f, b / 255.0f));
+        wakeUp();
     });
-    m_frameTimer->start();
+    connect(m_terminalModel, &TerminalModel::paletteColorReset, this, [this](int index) {
+        if (index < 0) m_particleSystem->resetPalette();
+        else m_particleSystem->resetPaletteColor(index);
+        wakeUp();
+    });
+    
+    // Frames, SSH polling and cursor blink are driven by the FrameScheduler
     m_elapsedTimer.start();
+    m_idleShimmerTimer.start();
     
     setFocusPolicy(Qt::StrongFocus);
     setMouseTracking(true); 
-    
-    // Blink Timer
-    m_blinkTimer = new QTimer(this);
-    connect(m_blinkTimer, &QTimer::timeout, this, [this](){
-        m_cursorBlinkState = !m_cursorBlinkState;
-        
-        // ASYMMETRIC BLINK:
-        // If ON: Stay ON for 1000ms (Solid)
-        // If OFF: Stay OFF for 200ms (Explosion duration)
-        if (m_cursorBlinkState) {
-            m_blinkTimer->setInterval(1000); 
-        } else {
-            m_blinkTimer->setInterval(200);
-        }
-
-        m_screenDirty = true;
-        update();
-    });
-    // Start in ON state, so ensure first timeout happens after 1000ms
-    m_cursorBlinkState = true; 
-    m_blinkTimer->start(1000); 
 }
 
 TerminalWidget::~TerminalWidget()
 {
     makeCurrent();
+    delete m_bloomPass;
+    delete m_renderScale;
     delete m_particleSystem;
     doneCurrent();
 }
@@ -108,13 +103,49 @@ bool TerminalWidget::isConnected() const
 
 void TerminalWidget::setRenderEnabled(bool enabled)
 {
-    if (enabled) {
-        if (!m_frameTimer->isActive()) m_frameTimer->start();
-    } else {
-        if (m_frameTimer->isActive()) m_frameTimer->stop();
+    m_renderEnabled = enabled;
+}
+
+void TerminalWidget::setFrameScheduler(FrameScheduler* scheduler)
+{
+    if (m_scheduler) m_scheduler->removeWidget(this);
+    m_scheduler = scheduler;
+    if (m_scheduler) m_scheduler->addWidget(this);
+}
+
+void TerminalWidget::pollConnection()
+{
+    m_sshClient->poll();
+}
+
+void TerminalWidget::requestFrame()
+{
+    if (!m_idle) {
+        update(); // Schedules paintGL
+    } else if (m_idleShimmer && m_idleShimmerTimer.elapsed() >= IDLE_SHIMMER_INTERVAL_MS) {
+        m_idleShimmerTimer.restart();
+        update();
+    } else if (m_cursorFramePending || m_particleSystem->isCursorAnimating()) {
+        update(); // Cursor layer frames only: the pane stays idle (no physics)
     }
 }
 
+void TerminalWidget::setCursorBlink(bool on)
+{
+    if (m_cursorBlinkState == on) return;
+    m_cursorBlinkState = on;
+    m_cursorFramePending = true; // Not a wakeUp(): that is for data, input and exposure
+}
+
+void TerminalWidget::wakeUp()
+{
+    if (m_idle) {
+        m_idle = false;
+        m_idleThisSecond = true;
+    }
+    m_settledFrames = 0; // Painted on the next scheduler tick
+}
+
 void TerminalWidget::initializeGL()
 {
     if (!initializeOpenGLFunctions()) {
@@ -126,7 +157,9 @@ void TerminalWidget::initializeGL()
     glBlendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE); 
     
     m_particleSystem->init();
-    m_particleSystem->resize(width(), height());
+    m_particleSystem->resize(width(), height(), devicePixelRatioF());
+    m_bloomPass->init();
+    m_renderScale->init();
 }
 
 void TerminalWidget::resizeGL(int w, int h)
@@ -144,46 +177,76 @@ void TerminalWidget::resizeGL(int w, int h)
     }
     
     if (m_particleSystem) {
-        m_particleSystem->resize(w, h);
+        m_particleSystem->resize(w, h, devicePixelRatioF());
         if (m_terminalModel) {
             m_particleSystem->updateParticlesFromTerminal(*m_terminalModel);
         }
     }
+    wakeUp();
 }
 
 void TerminalWidget::paintGL()
 {
-    float current = m_elapsedTimer.nsecsElapsed() / 1000000000.0f;
-    static float last = 0;
-    m_deltaTime = current - last;
-    last = current;
+    // Per-pane delta on the shared animation clock
+    double current = m_scheduler ? m_scheduler->now() : m_elapsedTimer.nsecsElapsed() / 1000000000.0;
+    m_deltaTime = (m_lastFrameTime < 0.0) ? 0.0f : (float)(current - m_lastFrameTime);
+    m_lastFrameTime = current;
 
     if (m_screenDirty) {
         if (m_particleSystem && m_terminalModel) {
-             m_particleSystem->updateParticlesFromTerminal(*m_terminalModel, 
-                m_terminalModel->cursorX(), 
-                m_terminalModel->cursorY(), 
-                m_cursorBlinkState,
-                m_selStart.x(), m_selStart.y(),
-                m_selEnd.x(), m_selEnd.y(),
-                m_hoveredLink.row, m_hoveredLink.startCol, m_hoveredLink.endCol);
+             m_particleSystem->updateParticlesFromTerminal(*m_terminalModel);
         }
         m_screenDirty = false;
     }
-
+    
     m_frameCount++;
-    static float timeAccum = 0;
-    timeAccum += m_deltaTime;
-    if (timeAccum >= 1.0f) {
-        m_particleSystem->adjustQuality(m_frameCount, 120.0f);
+    m_statsTime += m_deltaTime;
+    if (m_statsTime >= 1.0f) {
+        // Dynamic resolution owns quality control while enabled (frame time, not glow)
+        if (!m_idle && !m_idleThisSecond && !m_renderScale->isEnabled()) {
+            float targetFps = m_scheduler ? m_scheduler->targetFps(this) : 60.0f;
+            m_particleSystem->adjustQuality(m_frameCount / m_statsTime, targetFps);
+        }
+        m_idleThisSecond = m_idle;
         m_frameCount = 0;
-        timeAccum = 0;
+        m_statsTime = 0.0f;
     }
     
     // Beat Sim (Removed)
     
-    updatePhysics();
+    // GPU time of the whole frame (physics + draw) drives the render scale
+    m_renderScale->beginFrame();
+    if (m_idle) {
+        // Expose or idle shimmer frame: redraw settled particles, no dispatch
+        m_particleSystem->advanceClock(m_deltaTime);
+    } else {
+        updatePhysics();
+    }
+    
+    // Cursor, selection and link hover: uniform state only (the cursor follows the content into history).
+    // After the clock advance, so a blink toggle lands on this frame's time.
+    if (m_particleSystem && m_terminalModel) {
+        m_particleSystem->setCursor(m_terminalModel->cursorX(),
+                                    m_terminalModel->cursorY() + m_terminalModel->viewOffset(),
+                                    m_cursorBlinkState && m_terminalModel->isCursorVisible());
+        m_particleSystem->setSelection(m_selStart.x(), m_selStart.y(), m_selEnd.x(), m_selEnd.y());
+        m_particleSystem->setHoveredLink(m_hoveredLink.row, m_hoveredLink.startCol, m_hoveredLink.endCol);
+        m_cursorFramePending = false;
+    }
     renderParticles();
+    // Only animating frames steer the scale: idle and cache presents measure as nearly free
+    m_renderScale->endFrame(m_scheduler ? m_scheduler->frameBudget(this) : 1.0f / 60.0f,
+                            !m_idle && !m_particleSystem->presentedFromCache());
+    
+    // IDLE DETECTION: GPU reports nothing moving and no regeneration is pending
+    if (!m_idle && !m_screenDirty && m_particleSystem->isSettled()) {
+        if (++m_settledFrames >= IDLE_FRAME_THRESHOLD) {
+            m_idle = true;
+            m_idleShimmerTimer.restart();
+        }
+    } else {
+        m_settledFrames = 0;
+    }
 }
 
 void TerminalWidget::paintEvent(QPaintEvent *event)
@@ -294,11 +357,28 @@ void TerminalWidget::updatePhysics()
 
 void TerminalWidget::renderParticles()
 {
+    int fbWidth = (int)std::lround(width() * devicePixelRatioF());
+    int fbHeight = (int)std::lround(height() * devicePixelRatioF());
+    
+    // RENDER SCALE: over budget, the scene is drawn smaller and upscaled on composite
+    bool scaled = m_renderScale->begin(width(), height(), devicePixelRatioF());
+    int sceneWidth = scaled ? m_renderScale->sceneWidth() : fbWidth;
+    int sceneHeight = scaled ? m_renderScale->sceneHeight() : fbHeight;
+    m_particleSystem->resize(width(), height(), scaled ? m_renderScale->scenePixelRatio() : devicePixelRatioF());
+    GLuint sceneFbo = scaled ? m_renderScale->framebuffer() : defaultFramebufferObject();
+    
+    // BLOOM: particles (sharp cores) go to an offscreen target, the glow is added on composite
+    bool bloom = m_bloom && m_bloomPass->begin(sceneWidth, sceneHeight);
+    m_particleSystem->setBloom(bloom);
+    
     glClearColor(0.0f, 0.0f, 0.0f, m_opacity);
     glClear(GL_COLOR_BUFFER_BIT);
     QMatrix4x4 projection;
     projection.ortho(0, width(), height(), 0, -1, 1);
     m_particleSystem->render(projection);
+    
+    if (bloom) m_bloomPass->finish(sceneFbo, m_particleSystem->getGlowIntensity());
+    if (scaled) m_renderScale->finish(defaultFramebufferObject(), fbWidth, fbHeight);
 }
 
 
@@ -311,6 +391,22 @@ void TerminalWidget::sendData(const QByteArray& data)
 
 bool TerminalWidget::event(QEvent *event)
 {
+    // Input and exposure resume rendering immediately
+    switch (event->type()) {
+    case QEvent::KeyPress:
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseMove:
+    case QEvent::Wheel:
+    case QEvent::FocusIn:
+    case QEvent::Show:
+    case QEvent::WindowActivate:
+        wakeUp();
+        break;
+    default:
+        break;
+    }
+    
     if (event->type() == QEvent::KeyPress) {
         QKeyEvent *keyEvent = static_cast<QKeyEvent*>(event);
         if (keyEvent->key() == Qt::Key_Tab || keyEvent->key() == Qt::Key_Backtab) {
@@ -444,8 +540,7 @@ void TerminalWidget::mousePressEvent(QMouseEvent *event)
         m_selecting = true;
         m_selStart = pixelToCell(event->position());
         m_selEnd = m_selStart;
-        m_screenDirty = true;
-        update();
+        wakeUp();
     }
 }
 
@@ -474,8 +569,7 @@ void TerminalWidget::mouseReleaseEvent(QMouseEvent *event)
         if (hasSelection()) {
             copySelection();
         }
-        m_screenDirty = true;
-        update();
+        wakeUp();
     }
 }
 
@@ -502,8 +596,7 @@ void TerminalWidget::mouseMoveEvent(QMouseEvent *event)
     // Update selection during drag
     if (m_selecting) {
         m_selEnd = pixelToCell(event->position());
-        m_screenDirty = true;
-        update();
+        wakeUp(); // Overlay uniform only
     }
 }
 
@@ -530,30 +623,74 @@ void TerminalWidget::wheelEvent(QWheelEvent *event)
 }
 
 // Graphics Settings Delegation
-void TerminalWidget::setGlowIntensity(float val) { if (m_particleSystem) m_particleSystem->setGlowIntensity(val); }
-void TerminalWidget::setOpacity(float val) { m_opacity = val; update(); }
-void TerminalWidget::setBrightness(float val) { if (m_particleSystem) m_particleSystem->setBrightness(val); }
-void TerminalWidget::setVibrance(float val) { if (m_particleSystem) m_particleSystem->setVibrance(val); } // NEW
+void TerminalWidget::setGlowIntensity(float val) { if (m_particleSystem) m_particleSystem->setGlowIntensity(val); wakeUp(); }
+void TerminalWidget::setOpacity(float val) { m_opacity = val; wakeUp(); }
+void TerminalWidget::setBrightness(float val) { if (m_particleSystem) m_particleSystem->setBrightness(val); wakeUp(); }
+void TerminalWidget::setVibrance(float val) { if (m_particleSystem) m_particleSystem->setVibrance(val); wakeUp(); } // NEW
 void TerminalWidget::setSpringK(float val) { if (m_particleSystem) m_particleSystem->setSpringK(val); }
 void TerminalWidget::setDrag(float val) { if (m_particleSystem) m_particleSystem->setDrag(val); }
-void TerminalWidget::setShimmerSpeed(float val) { if (m_particleSystem) m_particleSystem->setShimmerSpeed(val); }
+void TerminalWidget::setShimmerSpeed(float val) { if (m_particleSystem) m_particleSystem->setShimmerSpeed(val); wakeUp(); }
 void TerminalWidget::setFont(int val) { if (m_particleSystem) m_particleSystem->setFontById(val); }
 void TerminalWidget::setDensity(int val) { 
     if (m_particleSystem) {
         m_particleSystem->setDensity(val);
         m_screenDirty = true; 
-        update();
+        wakeUp();
     }
 }
 void TerminalWidget::setZoomLevel(float zoom) { 
     if (m_particleSystem) {
         m_particleSystem->setZoomLevel(zoom);
         m_screenDirty = true;
-        update();
+        wakeUp();
+    }
+}
+void TerminalWidget::setAnimationStyle(int style) { if (m_particleSystem) m_particleSystem->setAnimationStyle(style); wakeUp(); }
+void TerminalWidget::setTheme(int theme) { if (m_particleSystem) m_particleSystem->setTheme(theme); wakeUp(); }
+void TerminalWidget::setGpuExpansion(bool enabled) {
+    if (m_particleSystem) {
+        m_particleSystem->setGpuExpansion(enabled);
+        m_screenDirty = true;
+        wakeUp();
+    }
+}
+void TerminalWidget::setCompactParticles(bool enabled) {
+    if (m_particleSystem) {
+        m_particleSystem->setCompactParticles(enabled); // Rebuilt in the next paintGL
+        m_screenDirty = true;
+        wakeUp();
     }
 }
-void TerminalWidget::setAnimationStyle(int style) { if (m_particleSystem) m_particleSystem->setAnimationStyle(style); }
-void TerminalWidget::setTheme(int theme) { if (m_particleSystem) m_particleSystem->setTheme(theme); }
+void TerminalWidget::setPointSprites(bool enabled) {
+    if (m_particleSystem) {
+        m_particleSystem->setPointSprites(enabled);
+        m_screenDirty = true;
+        wakeUp();
+    }
+}
+void TerminalWidget::setSplatRendering(bool enabled) {
+    if (m_particleSystem) {
+        m_particleSystem->setSplatRendering(enabled);
+        m_screenDirty = true;
+        wakeUp();
+    }
+}
+void TerminalWidget::setBloom(bool enabled) {
+    m_bloom = enabled; // Shader variant follows in the next renderParticles
+    wakeUp();
+}
+void TerminalWidget::setFrameCaching(bool enabled) {
+    if (m_particleSystem) {
+        m_particleSystem->setFrameCaching(enabled);
+        m_screenDirty = true;
+        wakeUp();
+    }
+}
+void TerminalWidget::setDynamicResolution(bool enabled) {
+    m_renderScale->setEnabled(enabled); // Native until the frame timer reports an overrun
+    wakeUp();
+}
+void TerminalWidget::setIdleShimmer(bool enabled) { m_idleShimmer = enabled; }
 
 // Getters 
 float TerminalWidget::getGlowIntensity() const { return m_particleSystem ? m_particleSystem->getGlowIntensity() : 1.0f; }
@@ -568,6 +705,14 @@ int TerminalWidget::getFont() const { return m_particleSystem ? m_particleSystem
 float TerminalWidget::getZoomLevel() const { return m_particleSystem ? m_particleSystem->getZoomLevel() : 1.0f; }
 int TerminalWidget::getTheme() const { return m_particleSystem ? m_particleSystem->getTheme() : 0; }
 int TerminalWidget::getAnimationStyle() const { return m_particleSystem ? m_particleSystem->getAnimationStyle() : 0; }
+bool TerminalWidget::getGpuExpansion() const { return m_particleSystem ? m_particleSystem->getGpuExpansion() : false; }
+bool TerminalWidget::getCompactParticles() const { return m_particleSystem ? m_particleSystem->getCompactParticles() : false; }
+bool TerminalWidget::getPointSprites() const { return m_particleSystem ? m_particleSystem->getPointSprites() : false; }
+bool TerminalWidget::getSplatRendering() const { return m_particleSystem ? m_particleSystem->getSplatRendering() : false; }
+bool TerminalWidget::getBloom() const { return m_bloom; }
+bool TerminalWidget::getFrameCaching() const { return m_particleSystem ? m_particleSystem->getFrameCaching() : false; }
+bool TerminalWidget::getDynamicResolution() const { return m_renderScale->isEnabled(); }
+bool TerminalWidget::getIdleShimmer() const { return m_idleShimmer; }
 
 // ==== Text Selection Methods ====
 
@@ -589,8 +734,7 @@ void TerminalWidget::clearSelection()
     m_selStart = QPoint(-1, -1);
     m_selEnd = QPoint(-1, -1);
     m_selecting = false;
-    m_screenDirty = true;
-    update();
+    wakeUp();
 }
 
 bool TerminalWidget::hasSelection() const
@@ -606,9 +750,8 @@ void TerminalWidget::detectLinkAt(QPoint pos)
     if (cell.x() < 0) {
         if (m_hoveredLink.isValid()) {
              m_hoveredLink.clear();
-             m_screenDirty = true;
              setCursor(Qt::ArrowCursor);
-             update();
+             wakeUp();
         }
         return;
     }
@@ -643,8 +786,7 @@ void TerminalWidget::detectLinkAt(QPoint pos)
             m_hoveredLink.endCol = match.capturedEnd() - 1;
             
             setCursor(Qt::PointingHandCursor);
-            m_screenDirty = true;
-            update();
+            wakeUp();
             return;
         }
     }
@@ -12,6 +12,9 @@
 #include "../ui/ConnectionDialog.h"
 
 class ParticleSystem;
+class BloomPass;
+class RenderScale;
+class FrameScheduler;
 
 class TerminalWidget : public QOpenGLWidget, protected QOpenGLFunctions_4_5_Core
 {
@@ -26,6 +29,13 @@ public:
     void sendData(const QByteArray& data);
     bool isConnected() const;
     void setRenderEnabled(bool enabled);
+    bool isRenderEnabled() const { return m_renderEnabled; }
+    
+    // Frame scheduling (see FrameScheduler)
+    void setFrameScheduler(FrameScheduler* scheduler);
+    void pollConnection();          // Every tick, even when hidden
+    void requestFrame();            // Tick for a visible pane; skipped while idle
+    void setCursorBlink(bool on);   // Shared blink phase
     
     // Graphics Settings
     void setGlowIntensity(float val);
@@ -40,6 +50,14 @@ public:
     void setZoomLevel(float val);
     void setTheme(int theme);
     void setAnimationStyle(int style);
+    void setGpuExpansion(bool enabled);
+    void setCompactParticles(bool enabled);
+    void setPointSprites(bool enabled);
+    void setSplatRendering(bool enabled);
+    void setBloom(bool enabled);
+    void setFrameCaching(bool enabled);
+    void setDynamicResolution(bool enabled);
+    void setIdleShimmer(bool enabled);
     
     float getGlowIntensity() const;
     float getOpacity() const;
@@ -53,6 +71,14 @@ public:
     float getZoomLevel() const;
     int getTheme() const;
     int getAnimationStyle() const;
+    bool getGpuExpansion() const;
+    bool getCompactParticles() const;
+    bool getPointSprites() const;
+    bool getSplatRendering() const;
+    bool getBloom() const;
+    bool getFrameCaching() const;
+    bool getDynamicResolution() const;
+    bool getIdleShimmer() const;
 
 protected:
     void initializeGL() override;
@@ -80,20 +106,34 @@ signals:
 private:
     void updatePhysics();
     void renderParticles();
+    void wakeUp(); // Leave idle mode and schedule a frame
 
-    QTimer* m_frameTimer;
-    QElapsedTimer m_elapsedTimer;
-    float m_deltaTime;
+    FrameScheduler* m_scheduler = nullptr;
+    bool m_renderEnabled = true;
+    QElapsedTimer m_elapsedTimer;  // Fallback clock without a scheduler
+    double m_lastFrameTime = -1.0; // This pane's previous frame on the shared clock
+    float m_deltaTime = 0.0f;
+    float m_statsTime = 0.0f;      // Seconds accumulated for the FPS stats
     int m_frameCount;
     
+    // Idle mode: no physics dispatch or repaint once nothing has moved for a while
+    bool m_idle = false;
+    bool m_idleThisSecond = false; // Frame count is not a quality signal then
+    int m_settledFrames = 0;
+    bool m_idleShimmer = false;    // Keep shimmering at a reduced rate while idle
+    QElapsedTimer m_idleShimmerTimer;
+    bool m_cursorFramePending = false; // Blink edge not yet handed to the cursor layer
+    
     ParticleSystem* m_particleSystem;
+    BloomPass* m_bloomPass;  // Post-process glow (offscreen scene), used while m_bloom is set
+    bool m_bloom = false;
+    RenderScale* m_renderScale; // Dynamic resolution: frame timing + scaled target / upscale
     class SshClient* m_sshClient;
     class TerminalModel* m_terminalModel;
     QWidget* m_parent;
     bool m_screenDirty = false;
     
-    // Cursor Blinking
-    QTimer* m_blinkTimer;
+    // Cursor Blinking (phase owned by the FrameScheduler)
     bool m_cursorBlinkState = true;
     
     // Text Selection (PuTTY-like)
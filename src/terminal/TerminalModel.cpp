@@ -74,6 +74,38 @@ int TerminalModel::cb_damage(VTermRect rect, void *user) {
     return 1;
 }
 
+int TerminalModel::cb_moverect(VTermRect dest, VTermRect src, void *user) {
+    TerminalModel *self = static_cast<TerminalModel*>(user);
+    if(!self) return 0;
+    
+    // Move our copy of the cells (vterm then only damages what was not moved)
+    int height = src.end_row - src.start_row;
+    int width = src.end_col - src.start_col;
+    std::vector<TerminalCell> moved;
+    moved.reserve(height * width);
+    for(int row = src.start_row; row < src.end_row; ++row) {
+        for(int col = src.start_col; col < src.end_col; ++col) {
+            moved.push_back(self->m_grid[row * self->m_cols + col]);
+        }
+    }
+    for(int row = 0; row < height; ++row) {
+        for(int col = 0; col < width; ++col) {
+            self->m_grid[(dest.start_row + row) * self->m_cols + dest.start_col + col] = moved[row * width + col];
+        }
+    }
+    
+    // Whole-screen vertical scroll: the renderer can rotate rows instead of regenerating them
+    bool fullWidth = (src.start_col == 0 && src.end_col == self->m_cols);
+    bool fullHeight = (std::min(src.start_row, dest.start_row) == 0 &&
+                       std::max(src.end_row, dest.end_row) == self->m_rows);
+    if (fullWidth && fullHeight) {
+        self->m_scrollPosition += src.start_row - dest.start_row;
+    }
+    
+    emit self->screenChanged();
+    return 1;
+}
+
 int TerminalModel::cb_movecursor(VTermPos pos, VTermPos oldpos, int visible, void *user) {
     TerminalModel *self = static_cast<TerminalModel*>(user);
     if(self) {
@@ -201,9 +233,69 @@ void TerminalModel::cb_output(const char *s, size_t len, void *user) {
     }
 }
 
+// OSC 4 color spec: rgb:R/G/B (1-4 hex digits per channel) or #RGB / #RRGGBB
+static bool parseColorSpec(const QByteArray& spec, quint8 rgb[3])
+{
+    QList<QByteArray> channels;
+    if (spec.startsWith("rgb:")) {
+        channels = spec.mid(4).split('/');
+    } else if (spec.startsWith('#') && (spec.size() == 4 || spec.size() == 7)) {
+        int digits = (spec.size() - 1) / 3;
+        for (int k = 0; k < 3; ++k) channels << spec.mid(1 + k * digits, digits);
+    }
+    if (channels.size() != 3) return false;
+    
+    for (int k = 0; k < 3; ++k) {
+        const QByteArray& hex = channels[k];
+        bool ok = false;
+        uint value = hex.toUInt(&ok, 16);
+        if (!ok || hex.isEmpty() || hex.size() > 4) return false;
+        uint max = (1u << (4 * hex.size())) - 1; // Scale n-digit channels to 8 bits
+        rgb[k] = (quint8)((value * 255 + max / 2) / max);
+    }
+    return true;
+}
+
+int TerminalModel::cb_osc(int command, VTermStringFragment frag, void *user) {
+    TerminalModel *self = static_cast<TerminalModel*>(user);
+    if (!self || (command != 4 && command != 104)) return 0;
+    
+    if (frag.initial) self->m_oscArgs.clear();
+    self->m_oscArgs.append(frag.str, (int)frag.len);
+    if (frag.final) self->handleOsc(command, self->m_oscArgs);
+    return 1;
+}
+
+void TerminalModel::handleOsc(int command, const QByteArray& args)
+{
+    QList<QByteArray> fields = args.split(';');
+    if (command == 104) {
+        // OSC 104 ; index ; index ... (no index = reset the whole palette)
+        if (args.isEmpty()) {
+            emit paletteColorReset(-1);
+            return;
+        }
+        for (const QByteArray& field : fields) {
+            bool ok = false;
+            int index = field.toInt(&ok);
+            if (ok && index >= 0 && index < 256) emit paletteColorReset(index);
+        }
+        return;
+    }
+    
+    // OSC 4 ; index ; spec [; index ; spec ...]. Queries ("?") are not answered.
+    for (int i = 0; i + 1 < fields.size(); i += 2) {
+        bool ok = false;
+        int index = fields[i].toInt(&ok);
+        quint8 rgb[3];
+        if (!ok || index < 0 || index >= 256 || !parseColorSpec(fields[i + 1], rgb)) continue;
+        emit paletteColorChanged(index, rgb[0], rgb[1], rgb[2]);
+    }
+}
+
 static VTermScreenCallbacks vterm_callbacks = {
     .damage = TerminalModel::cb_damage,
-    .moverect = nullptr,
+    .moverect = TerminalModel::cb_moverect,
     .movecursor = TerminalModel::cb_movecursor,
     .settermprop = TerminalModel::cb_settermprop,
     .bell = TerminalModel::cb_bell,
@@ -212,6 +304,11 @@ static VTermScreenCallbacks vterm_callbacks = {
     .sb_popline = TerminalModel::cb_sb_popline,
 };
 
+// Sequences libvterm's state layer does not handle itself (palette OSCs)
+static VTermStateFallbacks vterm_fallbacks = {
+    .osc = TerminalModel::cb_osc,
+};
+
 TerminalModel::TerminalModel(int cols, int rows, QObject* parent)
     : QObject(parent)
     , m_cols(cols)
@@ -226,6 +323,7 @@ TerminalModel::TerminalModel(int cols, int rows, QObject* parent)
     m_vts = vterm_obtain_screen(m_vt);
     vterm_screen_enable_altscreen(m_vts, 1);
     vterm_screen_set_callbacks(m_vts, &vterm_callbacks, this);
+    vterm_screen_set_unrecognised_fallbacks(m_vts, &vterm_fallbacks, this);
     
     // Reset state
     vterm_screen_reset(m_vts, 1); // 1=hard reset
@@ -324,16 +422,19 @@ void TerminalModel::showMessage(const QString& msg) {
 void TerminalModel::scrollView(int lines) {
     if (m_isAlternateScreen) return;
     
+    int previous = m_viewOffset;
     m_viewOffset += lines;
     if (m_viewOffset < 0) m_viewOffset = 0;
     int maxScroll = (int)m_scrollback.size();
     if (m_viewOffset > maxScroll) m_viewOffset = maxScroll;
+    m_scrollPosition -= m_viewOffset - previous; // Older lines push the content down
     
     emit screenChanged();
 }
 
 void TerminalModel::resetScroll() {
     if (m_viewOffset != 0) {
+        m_scrollPosition += m_viewOffset;
         m_viewOffset = 0;
         emit screenChanged();
     }
@@ -62,6 +62,10 @@ public:
     void resetScroll();
     int viewOffset() const { return m_viewOffset; }
     
+    // Rows the displayed content has moved up in total (output scrolls +, scrolling into history -).
+    // Renderers diff it between frames to reuse scrolled rows instead of regenerating them.
+    qint64 scrollPosition() const { return m_scrollPosition; }
+    
     // Cursor Access
     int cursorX() const { return m_cursorX; }
     int cursorY() const { return m_cursorY; }
@@ -81,12 +85,14 @@ public:
     
     // VTerm Callbacks (Static wrappers)
     static int cb_damage(VTermRect rect, void *user);
+    static int cb_moverect(VTermRect dest, VTermRect src, void *user);
     static int cb_movecursor(VTermPos pos, VTermPos oldpos, int visible, void *user);
     static int cb_sb_pushline(int cols, const VTermScreenCell *cells, void *user);
     static int cb_sb_popline(int cols, VTermScreenCell *cells, void *user);
     static int cb_bell(void *user);
     static int cb_settermprop(VTermProp prop, VTermValue *val, void *user);
     static void cb_output(const char *s, size_t len, void *user);
+    static int cb_osc(int command, VTermStringFragment frag, void *user); // Unrecognised OSC fallback
 
 signals:
     void screenChanged();
@@ -94,9 +100,13 @@ signals:
     void bellRing();
     void titleChanged(QString title);
     void dataOutput(QByteArray data); // Outgoing to SSH
+    void paletteColorChanged(int index, quint8 r, quint8 g, quint8 b); // OSC 4
+    void paletteColorReset(int index); // OSC 104 (-1 = every entry)
 
 private:
     void flushDamage(); // Sync vterm grid to our grid
+    void handleOsc(int command, const QByteArray& args);
+    QByteArray m_oscArgs; // OSC payload collected across string fragments
     
     VTerm* m_vt = nullptr;
     VTermScreen* m_vts = nullptr;
@@ -113,6 +123,7 @@ private:
     int m_cursorX = 0;
     int m_cursorY = 0;
     int m_viewOffset = 0; // >0 is looking into history
+    qint64 m_scrollPosition = 0;
     
     // State Flags (Synced from VTerm Props)
     bool m_isAlternateScreen = false;
@@ -3,6 +3,7 @@
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QGroupBox>
+#include <QCheckBox>
 
 GraphicsSettingsDialog::GraphicsSettingsDialog(QWidget *parent)
     : QDialog(parent)
@@ -41,6 +42,20 @@ void GraphicsSettingsDialog::setValues(float glow, float opacity, float brightne
     blockSignals(oldState);
 }
 
+void GraphicsSettingsDialog::setPerformanceOptions(bool gpuExpansion, bool compactParticles, bool pointSprites, bool splatRendering, bool bloom, bool frameCaching, bool dynamicResolution, bool idleShimmer)
+{
+    bool oldState = blockSignals(true);
+    m_gpuExpansionCheck->setChecked(gpuExpansion);
+    m_compactParticlesCheck->setChecked(compactParticles);
+    m_pointSpritesCheck->setChecked(pointSprites);
+    m_splatRenderingCheck->setChecked(splatRendering);
+    m_bloomCheck->setChecked(bloom);
+    m_frameCachingCheck->setChecked(frameCaching);
+    m_dynamicResolutionCheck->setChecked(dynamicResolution);
+    m_idleShimmerCheck->setChecked(idleShimmer);
+    blockSignals(oldState);
+}
+
 QSlider* GraphicsSettingsDialog::createSlider(const QString& labelText, int min, int max, int val, const QString& tooltip)
 {
     // Need access to layout? Layout is managed in setupUi.
@@ -148,6 +163,44 @@ void GraphicsSettingsDialog::setupUi()
     physicsLayout->addLayout(fontRow);
     
     mainLayout->addWidget(physicsGroup);
+    
+    // Performance Group
+    QGroupBox* perfGroup = new QGroupBox("Performance", this);
+    QVBoxLayout* perfLayout = new QVBoxLayout(perfGroup);
+    
+    m_gpuExpansionCheck = new QCheckBox("GPU Cell Expansion");
+    m_gpuExpansionCheck->setToolTip("Upload compact cells and build particles in a compute pass instead of on the CPU.");
+    perfLayout->addWidget(m_gpuExpansionCheck);
+    
+    m_compactParticlesCheck = new QCheckBox("Compact Particle Format");
+    m_compactParticlesCheck->setToolTip("Half-float positions and RGBA8 colors: ~3x less GPU memory and bandwidth per particle.");
+    perfLayout->addWidget(m_compactParticlesCheck);
+    
+    m_pointSpritesCheck = new QCheckBox("Point Sprite Particles");
+    m_pointSpritesCheck->setToolTip("Draw particles smaller than 3 screen pixels as single-vertex points instead of quads.");
+    perfLayout->addWidget(m_pointSpritesCheck);
+    
+    m_splatRenderingCheck = new QCheckBox("Compute Splat Renderer");
+    m_splatRenderingCheck->setToolTip("Rasterize particles up to 4 screen pixels in a compute pass instead of drawing quads. Fastest at high density.");
+    perfLayout->addWidget(m_splatRenderingCheck);
+    
+    m_bloomCheck = new QCheckBox("Post-Process Bloom");
+    m_bloomCheck->setToolTip("Draw sharp particle cores and add the glow as a half-resolution blur. Glow Intensity then costs one full-screen pass.");
+    perfLayout->addWidget(m_bloomCheck);
+    
+    m_frameCachingCheck = new QCheckBox("Static Frame Cache");
+    m_frameCachingCheck->setToolTip("Once the text settles, redraw the screen from a cached image and only re-render around changed cells. Idle shimmer stays live.");
+    perfLayout->addWidget(m_frameCachingCheck);
+    
+    m_dynamicResolutionCheck = new QCheckBox("Dynamic Resolution");
+    m_dynamicResolutionCheck->setToolTip("Render at down to half resolution when a frame takes longer than its GPU budget, then upscale with sharpening. Replaces the automatic glow reduction.");
+    perfLayout->addWidget(m_dynamicResolutionCheck);
+    
+    m_idleShimmerCheck = new QCheckBox("Shimmer While Idle");
+    m_idleShimmerCheck->setToolTip("Keep the shimmer animating at 10 FPS once the screen settles. Off = no redraws until something changes.");
+    perfLayout->addWidget(m_idleShimmerCheck);
+    
+    mainLayout->addWidget(perfGroup);
     mainLayout->addStretch();
     
     // CONNECTIONS
@@ -209,4 +262,36 @@ void GraphicsSettingsDialog::setupUi()
     connect(m_fontCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [=](int index){
         emit fontChanged(index);
     });
+    
+    connect(m_gpuExpansionCheck, &QCheckBox::toggled, this, [=](bool checked){
+        emit gpuExpansionChanged(checked);
+    });
+    
+    connect(m_compactParticlesCheck, &QCheckBox::toggled, this, [=](bool checked){
+        emit compactParticlesChanged(checked);
+    });
+    
+    connect(m_pointSpritesCheck, &QCheckBox::toggled, this, [=](bool checked){
+        emit pointSpritesChanged(checked);
+    });
+    
+    connect(m_splatRenderingCheck, &QCheckBox::toggled, this, [=](bool checked){
+        emit splatRenderingChanged(checked);
+    });
+    
+    connect(m_bloomCheck, &QCheckBox::toggled, this, [=](bool checked){
+        emit bloomChanged(checked);
+    });
+    
+    connect(m_frameCachingCheck, &QCheckBox::toggled, this, [=](bool checked){
+        emit frameCachingChanged(checked);
+    });
+    
+    connect(m_dynamicResolutionCheck, &QCheckBox::toggled, this, [=](bool checked){
+        emit dynamicResolutionChanged(checked);
+    });
+    
+    connect(m_idleShimmerCheck, &QCheckBox::toggled, this, [=](bool checked){
+        emit idleShimmerChanged(checked);
+    });
 }
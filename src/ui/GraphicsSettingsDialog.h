@@ -7,6 +7,7 @@
 #include <QLabel>
 #include <QDoubleSpinBox>
 #include <QComboBox>
+#include <QCheckBox>
 
 class GraphicsSettingsDialog : public QDialog
 {
@@ -17,6 +18,7 @@ public:
 
     // Initial values to sync UI
     void setValues(float glow, float opacity, float brightness, float springK, float drag, float shimmerSpeed, int density, int style, int theme, float vibrance, int font);
+    void setPerformanceOptions(bool gpuExpansion, bool compactParticles, bool pointSprites, bool splatRendering, bool bloom, bool frameCaching, bool dynamicResolution, bool idleShimmer);
 
 signals:
     void glowIntensityChanged(float val);
@@ -30,6 +32,14 @@ signals:
     void themeChanged(int theme);
     void fontChanged(int fontIndex); // NEW
     void vibranceChanged(float val); // NEW
+    void gpuExpansionChanged(bool enabled);
+    void compactParticlesChanged(bool enabled);
+    void pointSpritesChanged(bool enabled);
+    void splatRenderingChanged(bool enabled);
+    void bloomChanged(bool enabled);
+    void frameCachingChanged(bool enabled);
+    void dynamicResolutionChanged(bool enabled);
+    void idleShimmerChanged(bool enabled);
 
 private:
     void setupUi();
@@ -47,6 +57,14 @@ private:
     QComboBox* m_styleCombo;
     QComboBox* m_fontCombo; // NEW
     QComboBox* m_themeCombo;
+    QCheckBox* m_gpuExpansionCheck;
+    QCheckBox* m_compactParticlesCheck;
+    QCheckBox* m_pointSpritesCheck;
+    QCheckBox* m_splatRenderingCheck;
+    QCheckBox* m_bloomCheck;
+    QCheckBox* m_frameCachingCheck;
+    QCheckBox* m_dynamicResolutionCheck;
+    QCheckBox* m_idleShimmerCheck;
     
     QLabel* m_glowLabel;
     QLabel* m_opacityLabel;
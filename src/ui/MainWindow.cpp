@@ -4,6 +4,7 @@
 #include "../renderer/TerminalWidget.h"
 #include "ConnectionDialog.h"
 #include "GraphicsSettingsDialog.h"
+#include "../renderer/FrameScheduler.h"
 #include <QApplication>
 #include <QMessageBox>
 #include <QDebug>
@@ -13,6 +14,7 @@
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_tabWidget(new QTabWidget(this))
+    , m_frameScheduler(new FrameScheduler(this))
 {
     setupUi();
     setupMenu();
@@ -164,7 +166,7 @@ void MainWindow::setupShortcuts()
 
 TerminalTab* MainWindow::createNewTab()
 {
-    TerminalTab* tab = new TerminalTab(this);
+    TerminalTab* tab = new TerminalTab(m_frameScheduler, this);
     int index = m_tabWidget->addTab(tab, "Terminal");
     m_tabWidget->setCurrentIndex(index);
     return tab;
@@ -220,94 +222,42 @@ void MainWindow::updateTabTitle(int index, const QString& title)
     m_tabWidget->setTabText(index, title);
 }
 
+template <typename Value>
+void MainWindow::forwardToTabs(void (GraphicsSettingsDialog::*signal)(Value), void (TerminalTab::*setter)(Value))
+{
+    connect(m_graphicsDialog, signal, this, [this, setter](Value v){
+        for (int i = 0; i < m_tabWidget->count(); ++i) {
+            TerminalTab* tab = qobject_cast<TerminalTab*>(m_tabWidget->widget(i));
+            if (tab) (tab->*setter)(v);
+        }
+    });
+}
+
 void MainWindow::onGraphicsSettings()
 {
     if (!m_graphicsDialog) {
         m_graphicsDialog = new GraphicsSettingsDialog(this);
         
-        // Connect Dialog -> Current Tab -> Terminal
-        // Note: This connects GLOBAL settings. 
-        // Ideally we update ALL tabs or just the current?
-        // Let's stick to Current Tab for now, OR iterate all tabs.
-        // Or simpler: Dialog emits, MainWindow catches and iterates.
-        
-        connect(m_graphicsDialog, &GraphicsSettingsDialog::glowIntensityChanged, this, [this](float v){
-            for(int i=0; i<m_tabWidget->count(); ++i) {
-                TerminalTab* tab = qobject_cast<TerminalTab*>(m_tabWidget->widget(i));
-                if(tab) tab->setGlowIntensity(v);
-            }
-        });
-
-        connect(m_graphicsDialog, &GraphicsSettingsDialog::opacityChanged, this, [this](float v){
-            for(int i=0; i<m_tabWidget->count(); ++i) {
-                TerminalTab* tab = qobject_cast<TerminalTab*>(m_tabWidget->widget(i));
-                if(tab) tab->setOpacity(v);
-            }
-        });
-        
-        connect(m_graphicsDialog, &GraphicsSettingsDialog::brightnessChanged, this, [this](float v){
-            for(int i=0; i<m_tabWidget->count(); ++i) {
-                TerminalTab* tab = qobject_cast<TerminalTab*>(m_tabWidget->widget(i));
-                if(tab) tab->setBrightness(v);
-            }
-        });
-        
-        connect(m_graphicsDialog, &GraphicsSettingsDialog::vibranceChanged, this, [this](float v){
-            for(int i=0; i<m_tabWidget->count(); ++i) {
-                TerminalTab* tab = qobject_cast<TerminalTab*>(m_tabWidget->widget(i));
-                if(tab) tab->setVibrance(v);
-            }
-        });
-
-
-        connect(m_graphicsDialog, &GraphicsSettingsDialog::springKChanged, this, [this](float v){
-             for(int i=0; i<m_tabWidget->count(); ++i) {
-                TerminalTab* tab = qobject_cast<TerminalTab*>(m_tabWidget->widget(i));
-                 if(tab) tab->setSpringK(v);
-             }
-        });
-        
-        connect(m_graphicsDialog, &GraphicsSettingsDialog::dragChanged, this, [this](float v){
-             for(int i=0; i<m_tabWidget->count(); ++i) {
-                TerminalTab* tab = qobject_cast<TerminalTab*>(m_tabWidget->widget(i));
-                 if(tab) tab->setDrag(v);
-             }
-        });
-        
-        connect(m_graphicsDialog, &GraphicsSettingsDialog::shimmerSpeedChanged, this, [this](float v){
-             for(int i=0; i<m_tabWidget->count(); ++i) {
-                TerminalTab* tab = qobject_cast<TerminalTab*>(m_tabWidget->widget(i));
-                 if(tab) tab->setShimmerSpeed(v);
-             }
-        });
-        
-        connect(m_graphicsDialog, &GraphicsSettingsDialog::densityChanged, this, [this](int v){
-             for(int i=0; i<m_tabWidget->count(); ++i) {
-                TerminalTab* tab = qobject_cast<TerminalTab*>(m_tabWidget->widget(i));
-                 if(tab) tab->setDensity(v);
-             }
-        });
-
-        connect(m_graphicsDialog, &GraphicsSettingsDialog::animationStyleChanged, this, [this](int style){
-             for(int i=0; i<m_tabWidget->count(); ++i) {
-                TerminalTab* tab = qobject_cast<TerminalTab*>(m_tabWidget->widget(i));
-                 if(tab) tab->setAnimationStyle(style);
-             }
-        });
-        
-        connect(m_graphicsDialog, &GraphicsSettingsDialog::themeChanged, this, [this](int theme){
-             for(int i=0; i<m_tabWidget->count(); ++i) {
-                TerminalTab* tab = qobject_cast<TerminalTab*>(m_tabWidget->widget(i));
-                 if(tab) tab->setTheme(theme);
-             }
-        });
-        
-        connect(m_graphicsDialog, &GraphicsSettingsDialog::fontChanged, this, [this](int font){
-             for(int i=0; i<m_tabWidget->count(); ++i) {
-                TerminalTab* tab = qobject_cast<TerminalTab*>(m_tabWidget->widget(i));
-                 if(tab) tab->setFont(font);
-             }
-        });
+        // Settings are global: every tab follows the dialog
+        forwardToTabs(&GraphicsSettingsDialog::glowIntensityChanged, &TerminalTab::setGlowIntensity);
+        forwardToTabs(&GraphicsSettingsDialog::opacityChanged, &TerminalTab::setOpacity);
+        forwardToTabs(&GraphicsSettingsDialog::brightnessChanged, &TerminalTab::setBrightness);
+        forwardToTabs(&GraphicsSettingsDialog::vibranceChanged, &TerminalTab::setVibrance);
+        forwardToTabs(&GraphicsSettingsDialog::springKChanged, &TerminalTab::setSpringK);
+        forwardToTabs(&GraphicsSettingsDialog::dragChanged, &TerminalTab::setDrag);
+        forwardToTabs(&GraphicsSettingsDialog::shimmerSpeedChanged, &TerminalTab::setShimmerSpeed);
+        forwardToTabs(&GraphicsSettingsDialog::densityChanged, &TerminalTab::setDensity);
+        forwardToTabs(&GraphicsSettingsDialog::animationStyleChanged, &TerminalTab::setAnimationStyle);
+        forwardToTabs(&GraphicsSettingsDialog::themeChanged, &TerminalTab::setTheme);
+        forwardToTabs(&GraphicsSettingsDialog::fontChanged, &TerminalTab::setFont);
+        forwardToTabs(&GraphicsSettingsDialog::gpuExpansionChanged, &TerminalTab::setGpuExpansion);
+        forwardToTabs(&GraphicsSettingsDialog::compactParticlesChanged, &TerminalTab::setCompactParticles);
+        forwardToTabs(&GraphicsSettingsDialog::pointSpritesChanged, &TerminalTab::setPointSprites);
+        forwardToTabs(&GraphicsSettingsDialog::splatRenderingChanged, &TerminalTab::setSplatRendering);
+        forwardToTabs(&GraphicsSettingsDialog::bloomChanged, &TerminalTab::setBloom);
+        forwardToTabs(&GraphicsSettingsDialog::frameCachingChanged, &TerminalTab::setFrameCaching);
+        forwardToTabs(&GraphicsSettingsDialog::dynamicResolutionChanged, &TerminalTab::setDynamicResolution);
+        forwardToTabs(&GraphicsSettingsDialog::idleShimmerChanged, &TerminalTab::setIdleShimmer);
     }
     
     // Sync UI with current tab (if exists)
@@ -326,6 +276,8 @@ void MainWindow::onGraphicsSettings()
             tab->getVibrance(),
             tab->getFont()
         );
+        m_graphicsDialog->setPerformanceOptions(tab->getGpuExpansion(), tab->getCompactParticles(), tab->getPointSprites(), tab->getSplatRendering(),
+                                                tab->getBloom(), tab->getFrameCaching(), tab->getDynamicResolution(), tab->getIdleShimmer());
     }
     
     m_graphicsDialog->show();
@@ -10,6 +10,8 @@
 
 class TerminalWidget;
 class TerminalTab;
+class FrameScheduler;
+class GraphicsSettingsDialog;
 
 class MainWindow : public QMainWindow
 {
@@ -33,7 +35,12 @@ private:
     void setupMenu();
     void setupShortcuts();
 
+    // Connects a dialog signal to the matching setter on every tab
+    template <typename Value>
+    void forwardToTabs(void (GraphicsSettingsDialog::*signal)(Value), void (TerminalTab::*setter)(Value));
+
     QTabWidget* m_tabWidget;
+    FrameScheduler* m_frameScheduler; // One tick for every pane
     
     // Menus
     QMenu* m_fileMenu;
@@ -41,5 +48,5 @@ private:
     QMenu* m_helpMenu;
     
     // Dialogs
-    class GraphicsSettingsDialog* m_graphicsDialog = nullptr;
+    GraphicsSettingsDialog* m_graphicsDialog = nullptr;
 };
@@ -2,9 +2,10 @@
 #include <QDebug>
 #include <QApplication>
 
-TerminalTab::TerminalTab(QWidget* parent)
+TerminalTab::TerminalTab(FrameScheduler* scheduler, QWidget* parent)
     : QWidget(parent)
     , m_layout(new QVBoxLayout(this))
+    , m_scheduler(scheduler)
 {
     m_layout->setContentsMargins(0, 0, 0, 0);
     m_layout->setSpacing(0);
@@ -30,6 +31,7 @@ void TerminalTab::setupInitialTerminal()
 {
     // Start with a single TerminalWidget
     TerminalWidget* term = new TerminalWidget(this);
+    term->setFrameScheduler(m_scheduler);
     m_layout->addWidget(term);
     setActiveTerminal(term);
     m_terminals.append(term);
@@ -132,6 +134,7 @@ void TerminalTab::split(Qt::Orientation orientation)
 
     // Create new terminal
     TerminalWidget* newTerm = new TerminalWidget(this);
+    newTerm->setFrameScheduler(m_scheduler);
     m_terminals.append(newTerm);
     
     // Find parent of current terminal
@@ -193,6 +196,14 @@ void TerminalTab::setFont(int val) { for(auto* t : m_terminals) t->setFont(val);
 void TerminalTab::setZoomLevel(float val) { for(auto* t : m_terminals) t->setZoomLevel(val); }
 void TerminalTab::setTheme(int theme) { for(auto* t : m_terminals) t->setTheme(theme); }
 void TerminalTab::setAnimationStyle(int style) { for(auto* t : m_terminals) t->setAnimationStyle(style); }
+void TerminalTab::setGpuExpansion(bool enabled) { for(auto* t : m_terminals) t->setGpuExpansion(enabled); }
+void TerminalTab::setCompactParticles(bool enabled) { for(auto* t : m_terminals) t->setCompactParticles(enabled); }
+void TerminalTab::setPointSprites(bool enabled) { for(auto* t : m_terminals) t->setPointSprites(enabled); }
+void TerminalTab::setSplatRendering(bool enabled) { for(auto* t : m_terminals) t->setSplatRendering(enabled); }
+void TerminalTab::setBloom(bool enabled) { for(auto* t : m_terminals) t->setBloom(enabled); }
+void TerminalTab::setFrameCaching(bool enabled) { for(auto* t : m_terminals) t->setFrameCaching(enabled); }
+void TerminalTab::setDynamicResolution(bool enabled) { for(auto* t : m_terminals) t->setDynamicResolution(enabled); }
+void TerminalTab::setIdleShimmer(bool enabled) { for(auto* t : m_terminals) t->setIdleShimmer(enabled); }
 
 float TerminalTab::getGlowIntensity() const { return m_activeTerminal ? m_activeTerminal->getGlowIntensity() : 1.0f; }
 float TerminalTab::getOpacity() const { return m_activeTerminal ? m_activeTerminal->getOpacity() : 0.85f; } 
@@ -206,3 +217,11 @@ float TerminalTab::getZoomLevel() const { return m_activeTerminal ? m_activeTerm
 int TerminalTab::getTheme() const { return m_activeTerminal ? m_activeTerminal->getTheme() : 0; }
 int TerminalTab::getFont() const { return m_activeTerminal ? m_activeTerminal->getFont() : 0; }
 int TerminalTab::getAnimationStyle() const { return m_activeTerminal ? m_activeTerminal->getAnimationStyle() : 0; }
+bool TerminalTab::getGpuExpansion() const { return m_activeTerminal ? m_activeTerminal->getGpuExpansion() : false; }
+bool TerminalTab::getCompactParticles() const { return m_activeTerminal ? m_activeTerminal->getCompactParticles() : false; }
+bool TerminalTab::getPointSprites() const { return m_activeTerminal ? m_activeTerminal->getPointSprites() : false; }
+bool TerminalTab::getSplatRendering() const { return m_activeTerminal ? m_activeTerminal->getSplatRendering() : false; }
+bool TerminalTab::getBloom() const { return m_activeTerminal ? m_activeTerminal->getBloom() : false; }
+bool TerminalTab::getFrameCaching() const { return m_activeTerminal ? m_activeTerminal->getFrameCaching() : false; }
+bool TerminalTab::getDynamicResolution() const { return m_activeTerminal ? m_activeTerminal->getDynamicResolution() : false; }
+bool TerminalTab::getIdleShimmer() const { return m_activeTerminal ? m_activeTerminal->getIdleShimmer() : false; }
@@ -9,12 +9,14 @@
 #include <QHideEvent>
 #include "../renderer/TerminalWidget.h"
 
+class FrameScheduler;
+
 class TerminalTab : public QWidget
 {
     Q_OBJECT
 
 public:
-    explicit TerminalTab(QWidget* parent = nullptr);
+    explicit TerminalTab(FrameScheduler* scheduler, QWidget* parent = nullptr);
     ~TerminalTab();
 
 protected:
@@ -51,6 +53,14 @@ public:
     void setZoomLevel(float val);
     void setTheme(int theme);
     void setAnimationStyle(int style);
+    void setGpuExpansion(bool enabled);
+    void setCompactParticles(bool enabled);
+    void setPointSprites(bool enabled);
+    void setSplatRendering(bool enabled);
+    void setBloom(bool enabled);
+    void setFrameCaching(bool enabled);
+    void setDynamicResolution(bool enabled);
+    void setIdleShimmer(bool enabled);
     
     // Getters (from active)
     float getGlowIntensity() const;
@@ -65,6 +75,14 @@ public:
     float getZoomLevel() const;
     int getTheme() const;
     int getAnimationStyle() const;
+    bool getGpuExpansion() const;
+    bool getCompactParticles() const;
+    bool getPointSprites() const;
+    bool getSplatRendering() const;
+    bool getBloom() const;
+    bool getFrameCaching() const;
+    bool getDynamicResolution() const;
+    bool getIdleShimmer() const;
 
 private:
     void setupInitialTerminal();
@@ -75,6 +93,7 @@ private:
     QSplitter* findParentSplitter(QWidget* widget);
 
     QVBoxLayout* m_layout;
+    FrameScheduler* m_scheduler;
     TerminalWidget* m_activeTerminal = nullptr;
     QList<TerminalWidget*> m_terminals;
     bool m_broadcastInput = false;